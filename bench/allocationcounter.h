@@ -0,0 +1,38 @@
+/*
+  * Copyright (C) 2016 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef BENCH_ALLOCATIONCOUNTER_H
+#define BENCH_ALLOCATIONCOUNTER_H
+
+#include <cstdint>
+
+/// Counts the heap allocations made by the program. The global operator new
+/// is replaced, so this only needs to be linked into the benchmark.
+namespace AllocationCounter
+{
+struct Counts
+{
+    int64_t myAllocations;
+    int64_t myBytes;
+};
+
+/// Returns the number of allocations and the number of bytes allocated since
+/// the program started.
+Counts get();
+}
+
+#endif
@@ -0,0 +1,449 @@
+/*
+  * Copyright (C) 2016 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "benchmarkrunner.h"
+
+#include <algorithm>
+#include <app/appinfo.h>
+#include <app/settingsmanager.h>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/program_options.hpp>
+#include <formats/fileformatmanager.h>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <midi/midifile.h>
+#include <midi/timemap.h>
+#include <painters/layoutinfo.h>
+#include <QApplication>
+#include <score/score.h>
+#include <score/serialization.h>
+#include <score/utils/scoremerger.h>
+#include <score/utils/scorepolisher.h>
+#include <sstream>
+#include <string>
+#include <testutil/scoregenerator.h>
+#include <utility>
+#include <vector>
+
+namespace
+{
+struct CorpusScore
+{
+    std::string myName;
+    Score myScore;
+    /// The score in .pt2 format, for making copies of it.
+    std::string myData;
+};
+
+typedef std::vector<std::unique_ptr<CorpusScore>> Corpus;
+
+/// Finds the files in the directory that can be imported.
+std::vector<std::string> findCorpusFiles(const FileFormatManager &manager,
+                                         const boost::filesystem::path &dir)
+{
+    std::vector<std::string> files;
+    if (!boost::filesystem::is_directory(dir))
+        return files;
+
+    for (auto it = boost::filesystem::directory_iterator(dir);
+         it != boost::filesystem::directory_iterator(); ++it)
+    {
+        const boost::filesystem::path &path = it->path();
+        std::string extension = path.extension().string();
+        if (!extension.empty())
+            extension.erase(0, 1);
+
+        if (manager.findFormat(extension))
+            files.push_back(path.string());
+    }
+
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+void loadMidi(const Score &score)
+{
+    MidiFile::LoadOptions options;
+    options.myEnableMetronome = true;
+    options.myRecordPositionChanges = true;
+
+    MidiFile file;
+    file.load(score, options);
+}
+
+void layoutScore(const Score &score)
+{
+    int systemIndex = 0;
+    for (const System &system : score.getSystems())
+    {
+        int staffIndex = 0;
+        for (const Staff &staff : system.getStaves())
+            LayoutInfo layout(score, system, systemIndex, staff, staffIndex++);
+
+        ++systemIndex;
+    }
+}
+
+void findPlayers(const Score &score)
+{
+    int systemIndex = 0;
+    for (const System &system : score.getSystems())
+    {
+        for (const Staff &staff : system.getStaves())
+        {
+            for (const Voice &voice : staff.getVoices())
+            {
+                for (const Position &pos : voice.getPositions())
+                {
+                    ScoreUtils::getCurrentPlayers(score, systemIndex,
+                                                  pos.getPosition());
+                }
+            }
+        }
+
+        ++systemIndex;
+    }
+}
+
+/// Runs a benchmark for each score in the corpus, and a benchmark for the
+/// entire corpus.
+void runForCorpus(BenchmarkRunner &runner, const std::string &name,
+                  const Corpus &corpus,
+                  const std::function<void(const Score &)> &body)
+{
+    for (const auto &score : corpus)
+        runner.run(name + "/" + score->myName, [&]() { body(score->myScore); });
+
+    runner.run("Corpus/" + name, [&]() {
+        for (const auto &score : corpus)
+            body(score->myScore);
+    });
+}
+
+/// Runs benchmarks on synthetic scores of increasing size, to check that the
+/// running time grows linearly with the length of the score.
+void runGenerated(BenchmarkRunner &runner, const std::vector<int> &sizes)
+{
+    for (int systemCount : sizes)
+    {
+        const std::string suffix = "/" + std::to_string(systemCount);
+        ScoreGenerator::Options generatorOptions;
+        generatorOptions.mySystemCount = systemCount;
+        Score score;
+        ScoreGenerator::generate(score, generatorOptions);
+
+        std::ostringstream os;
+        ScoreUtils::save(os, "score", score);
+        const std::string data = os.str();
+
+        runner.run("Generated/Serialization/Save" + suffix, [&]() {
+            std::ostringstream os;
+            ScoreUtils::save(os, "score", score);
+        });
+
+        std::unique_ptr<Score> loaded;
+        runner.run("Generated/Serialization/Load" + suffix,
+                   [&]() { loaded.reset(new Score()); },
+                   [&]() {
+                       std::istringstream is(data);
+                       ScoreUtils::load(is, "score", *loaded);
+                   });
+        runner.run("Generated/MidiFile::load" + suffix,
+                   [&]() { loadMidi(score); });
+        runner.run("Generated/TimeMap::update" + suffix, [&]() {
+            TimeMap timeMap;
+            timeMap.update(score);
+        });
+        runner.run("Generated/LayoutInfo" + suffix,
+                   [&]() { layoutScore(score); });
+
+        // Query the players at every position, as is done when rendering or
+        // generating MIDI events after the score has been edited.
+        runner.run("Generated/getCurrentPlayers" + suffix,
+                   [&]() { score.invalidatePlayerChanges(); },
+                   [&]() { findPlayers(score); });
+    }
+}
+
+/// Compares the timings for the smallest and largest generated scores, and
+/// returns false if any benchmark grew much faster than the score's size.
+bool checkScaling(const BenchmarkRunner &runner, int smallSize, int largeSize)
+{
+    // Allow for noise and cache effects on top of linear growth.
+    const double maxRatio = 1.5 * largeSize / smallSize;
+    const std::string smallSuffix = "/" + std::to_string(smallSize);
+    const std::string largeSuffix = "/" + std::to_string(largeSize);
+
+    bool success = true;
+    for (const BenchmarkRunner::Result &small : runner.getResults())
+    {
+        const std::string &name = small.myName;
+        if (name.size() < smallSuffix.size() ||
+            name.compare(name.size() - smallSuffix.size(), smallSuffix.size(),
+                         smallSuffix) != 0)
+        {
+            continue;
+        }
+
+        const std::string baseName =
+            name.substr(0, name.size() - smallSuffix.size());
+        auto large = std::find_if(
+            runner.getResults().begin(), runner.getResults().end(),
+            [&](const BenchmarkRunner::Result &result) {
+                return result.myName == baseName + largeSuffix;
+            });
+        if (large == runner.getResults().end())
+            continue;
+
+        const double ratio = large->myMedian / small.myMedian;
+        const bool ok = ratio <= maxRatio;
+        std::cout << std::left << std::setw(60) << baseName << std::right
+                  << std::fixed << std::setprecision(1) << std::setw(10)
+                  << ratio << "x" << (ok ? "" : "  FAILED") << std::endl;
+        success &= ok;
+    }
+
+    return success;
+}
+
+/// Scores can't be copied directly, so make a copy by loading the serialized
+/// score.
+void copyScore(const CorpusScore &source, std::unique_ptr<Score> &dest)
+{
+    dest.reset(new Score());
+    std::istringstream is(source.myData);
+    ScoreUtils::load(is, "score", *dest);
+}
+}
+
+/// Runs microbenchmarks (individual files) and macrobenchmarks (the entire
+/// corpus) for the core parts of the editor, and reports the timings.
+int main(int argc, char *argv[])
+{
+    // The layout code requires a QApplication, but there is no need for a
+    // display.
+    if (qgetenv("QT_QPA_PLATFORM").isEmpty())
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+
+    BenchmarkRunner::Options options;
+    std::string output;
+    std::vector<std::string> files;
+    bool checkScalingMode = false;
+
+    namespace po = boost::program_options;
+    po::options_description desc("Usage: pte_bench [options] [files...]"
+                                 "\nBenchmarks loading, saving, playback and "
+                                 "layout for a corpus of scores. By default, "
+                                 "the test data files are used."
+                                 "\n\nOptions");
+    try
+    {
+        desc.add_options()
+            ("help,h", "Displays this help.")
+            ("filter", po::value<std::string>(&options.myFilter),
+             "Only runs benchmarks whose name contains this string.")
+            ("min-time", po::value<double>(&options.myMinTime)
+                             ->default_value(options.myMinTime),
+             "Minimum time (in seconds) to run each benchmark for.")
+            ("min-iterations", po::value<int>(&options.myMinIterations)
+                                   ->default_value(options.myMinIterations),
+             "Minimum number of iterations for each benchmark.")
+            ("output,o", po::value<std::string>(&output),
+             "Writes the results to this file in JSON format.")
+            ("check-scaling",
+             "Only benchmarks the synthetic scores, and fails if the time "
+             "for a score with 10x as many systems grows by more than 15x.")
+            ("files", po::value<std::vector<std::string>>(&files),
+             "The scores to benchmark.");
+        po::positional_options_description p;
+        p.add("files", -1);
+        po::variables_map vm;
+        po::store(po::command_line_parser(argc, argv)
+                      .options(desc)
+                      .positional(p)
+                      .run(),
+                  vm);
+        po::notify(vm);
+
+        if (vm.count("help"))
+        {
+            std::cout << desc << std::endl;
+            return EXIT_SUCCESS;
+        }
+
+        checkScalingMode = vm.count("check-scaling") > 0;
+    }
+    catch (po::error &e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl << std::endl;
+        std::cerr << desc << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (checkScalingMode)
+    {
+        BenchmarkRunner runner(options);
+        runGenerated(runner, { 500, 5000 });
+
+        std::cout << std::endl;
+        const bool success = checkScaling(runner, 500, 5000);
+        return success ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    SettingsManager settingsManager;
+    FileFormatManager formatManager(settingsManager);
+
+    if (files.empty())
+    {
+        files =
+            findCorpusFiles(formatManager, AppInfo::getAbsolutePath("data"));
+    }
+
+    if (files.empty())
+    {
+        std::cerr << "No files to benchmark." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    BenchmarkRunner runner(options);
+
+    // Importers.
+    Corpus corpus;
+    std::vector<std::pair<std::string, FileFormat>> formats;
+    for (const std::string &file : files)
+    {
+        const boost::filesystem::path path(file);
+        std::string extension = path.extension().string();
+        if (!extension.empty())
+            extension.erase(0, 1);
+
+        boost::optional<FileFormat> format =
+            formatManager.findFormat(extension);
+        if (!format)
+        {
+            std::cerr << file << ": unsupported file type." << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        std::unique_ptr<CorpusScore> score(new CorpusScore());
+        score->myName = path.filename().string();
+        formatManager.importFile(score->myScore, file, *format);
+
+        std::ostringstream os;
+        ScoreUtils::save(os, "score", score->myScore);
+        score->myData = os.str();
+
+        std::unique_ptr<Score> imported;
+        runner.run("Import/" + score->myName,
+                   [&]() { imported.reset(new Score()); },
+                   [&]() {
+                       formatManager.importFile(*imported, file, *format);
+                   });
+
+        corpus.push_back(std::move(score));
+        formats.emplace_back(file, *format);
+    }
+
+    // The allocation counts for the entire corpus show the effect of changes
+    // to how the score is stored in memory.
+    std::vector<std::unique_ptr<Score>> importedScores;
+    runner.run("Corpus/Import",
+               [&]() {
+                   importedScores.clear();
+                   for (size_t i = 0; i < formats.size(); ++i)
+                       importedScores.emplace_back(new Score());
+               },
+               [&]() {
+                   for (size_t i = 0; i < formats.size(); ++i)
+                   {
+                       formatManager.importFile(*importedScores[i],
+                                                formats[i].first,
+                                                formats[i].second);
+                   }
+               });
+
+    // .pt2 serialization, without the gzip compression.
+    runForCorpus(runner, "Serialization/Save", corpus, [](const Score &score) {
+        std::ostringstream os;
+        ScoreUtils::save(os, "score", score);
+    });
+
+    for (const auto &score : corpus)
+    {
+        std::unique_ptr<Score> loaded;
+        runner.run("Serialization/Load/" + score->myName,
+                   [&]() { loaded.reset(new Score()); },
+                   [&]() {
+                       std::istringstream is(score->myData);
+                       ScoreUtils::load(is, "score", *loaded);
+                   });
+    }
+
+    runForCorpus(runner, "MidiFile::load", corpus, &loadMidi);
+
+    runForCorpus(runner, "LayoutInfo", corpus, &layoutScore);
+
+    // The benchmarks below modify the score, so they run on a copy that is
+    // made outside of the timed section.
+    for (const auto &score : corpus)
+    {
+        std::unique_ptr<Score> copy;
+        runner.run("polishScore/" + score->myName,
+                   [&]() { copyScore(*score, copy); },
+                   [&]() { ScoreUtils::polishScore(*copy); });
+    }
+
+    // Merge each score with itself, as the 1.7 importer does with the guitar
+    // and bass scores.
+    for (const auto &score : corpus)
+    {
+        std::unique_ptr<Score> dest;
+        std::unique_ptr<Score> guitar;
+        std::unique_ptr<Score> bass;
+        runner.run("ScoreMerger::merge/" + score->myName,
+                   [&]() {
+                       dest.reset(new Score());
+                       copyScore(*score, guitar);
+                       copyScore(*score, bass);
+                   },
+                   [&]() { ScoreMerger::merge(*dest, *guitar, *bass); });
+    }
+
+    runGenerated(runner, { 10, 100, 500, 1000, 5000 });
+
+    std::cout << std::endl;
+    runner.printResults(std::cout);
+
+    if (!output.empty())
+    {
+        boost::filesystem::ofstream os(output);
+        if (!os)
+        {
+            std::cerr << "Error opening " << output << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        runner.saveToJSON(os);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,169 @@
+/*
+  * Copyright (C) 2016 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "benchmarkrunner.h"
+
+#include "allocationcounter.h"
+#include <algorithm>
+#include <app/appinfo.h>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <rapidjson/prettywriter.h>
+#include <util/rapidjson_iostreams.h>
+
+BenchmarkRunner::Options::Options()
+    : myMinTime(0.5), myMinIterations(5), myMaxIterations(10000)
+{
+}
+
+BenchmarkRunner::BenchmarkRunner(const Options &options) : myOptions(options)
+{
+}
+
+void BenchmarkRunner::run(const std::string &name,
+                          const std::function<void()> &setup,
+                          const std::function<void()> &body)
+{
+    if (name.find(myOptions.myFilter) == std::string::npos)
+        return;
+
+    typedef std::chrono::steady_clock Clock;
+
+    // Warm up any caches before timing.
+    setup();
+    body();
+
+    std::vector<double> timings;
+    double total = 0;
+    AllocationCounter::Counts allocated = { 0, 0 };
+    while (static_cast<int>(timings.size()) < myOptions.myMaxIterations &&
+           (static_cast<int>(timings.size()) < myOptions.myMinIterations ||
+            total < myOptions.myMinTime * 1000))
+    {
+        setup();
+
+        const AllocationCounter::Counts startCounts = AllocationCounter::get();
+        const Clock::time_point start = Clock::now();
+        body();
+        const Clock::time_point end = Clock::now();
+        const AllocationCounter::Counts endCounts = AllocationCounter::get();
+
+        allocated.myAllocations +=
+            endCounts.myAllocations - startCounts.myAllocations;
+        allocated.myBytes += endCounts.myBytes - startCounts.myBytes;
+
+        const double elapsed =
+            std::chrono::duration<double, std::milli>(end - start).count();
+        timings.push_back(elapsed);
+        total += elapsed;
+    }
+
+    std::sort(timings.begin(), timings.end());
+
+    Result result;
+    result.myName = name;
+    result.myIterations = static_cast<int>(timings.size());
+    result.myMin = timings.front();
+    result.myMedian = timings[timings.size() / 2];
+    result.myMean = total / timings.size();
+
+    double variance = 0;
+    for (double t : timings)
+        variance += (t - result.myMean) * (t - result.myMean);
+    result.myStdDev = std::sqrt(variance / timings.size());
+
+    result.myAllocations =
+        static_cast<double>(allocated.myAllocations) / timings.size();
+    result.myAllocatedBytes =
+        static_cast<double>(allocated.myBytes) / timings.size();
+
+    myResults.push_back(result);
+
+    std::cerr << std::left << std::setw(60) << name << std::right << std::fixed
+              << std::setprecision(3) << std::setw(12) << result.myMedian
+              << " ms" << std::endl;
+}
+
+void BenchmarkRunner::run(const std::string &name,
+                          const std::function<void()> &body)
+{
+    run(name, []() {}, body);
+}
+
+const std::vector<BenchmarkRunner::Result> &BenchmarkRunner::getResults() const
+{
+    return myResults;
+}
+
+void BenchmarkRunner::printResults(std::ostream &os) const
+{
+    os << std::left << std::setw(60) << "Benchmark" << std::right
+       << std::setw(12) << "Iterations" << std::setw(14) << "Min (ms)"
+       << std::setw(14) << "Median (ms)" << std::setw(14) << "Mean (ms)"
+       << std::setw(14) << "Allocations" << std::setw(14) << "Alloc (KB)"
+       << std::endl;
+
+    for (const Result &result : myResults)
+    {
+        os << std::left << std::setw(60) << result.myName << std::right
+           << std::setw(12) << result.myIterations << std::fixed
+           << std::setprecision(3) << std::setw(14) << result.myMin
+           << std::setw(14) << result.myMedian << std::setw(14)
+           << result.myMean << std::setprecision(0) << std::setw(14)
+           << result.myAllocations << std::setw(14)
+           << result.myAllocatedBytes / 1024 << std::endl;
+    }
+}
+
+void BenchmarkRunner::saveToJSON(std::ostream &os) const
+{
+    Util::RapidJSON::OStreamWrapper stream(os);
+    rapidjson::PrettyWriter<Util::RapidJSON::OStreamWrapper> writer(stream);
+
+    writer.StartObject();
+    writer.Key("version");
+    writer.String(AppInfo::APPLICATION_VERSION);
+    writer.Key("benchmarks");
+    writer.StartArray();
+
+    for (const Result &result : myResults)
+    {
+        writer.StartObject();
+        writer.Key("name");
+        writer.String(result.myName.c_str(), result.myName.length());
+        writer.Key("iterations");
+        writer.Int(result.myIterations);
+        writer.Key("min_ms");
+        writer.Double(result.myMin);
+        writer.Key("median_ms");
+        writer.Double(result.myMedian);
+        writer.Key("mean_ms");
+        writer.Double(result.myMean);
+        writer.Key("stddev_ms");
+        writer.Double(result.myStdDev);
+        writer.Key("allocations");
+        writer.Double(result.myAllocations);
+        writer.Key("allocated_bytes");
+        writer.Double(result.myAllocatedBytes);
+        writer.EndObject();
+    }
+
+    writer.EndArray();
+    writer.EndObject();
+}
@@ -0,0 +1,80 @@
+/*
+  * Copyright (C) 2016 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef BENCH_BENCHMARKRUNNER_H
+#define BENCH_BENCHMARKRUNNER_H
+
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+/// Runs benchmarks and collects the timing results.
+class BenchmarkRunner
+{
+public:
+    struct Options
+    {
+        Options();
+
+        /// Only run benchmarks whose name contains this string.
+        std::string myFilter;
+        /// Each benchmark is run for at least this many seconds ...
+        double myMinTime;
+        /// ... and at least this many iterations.
+        int myMinIterations;
+        int myMaxIterations;
+    };
+
+    struct Result
+    {
+        std::string myName;
+        int myIterations;
+        /// Timings for a single iteration, in milliseconds.
+        double myMin;
+        double myMedian;
+        double myMean;
+        double myStdDev;
+        /// The average number of heap allocations and bytes allocated by a
+        /// single iteration.
+        double myAllocations;
+        double myAllocatedBytes;
+    };
+
+    explicit BenchmarkRunner(const Options &options);
+
+    /// Times the body repeatedly. The setup function is run before each
+    /// iteration, but is not included in the timings.
+    void run(const std::string &name, const std::function<void()> &setup,
+             const std::function<void()> &body);
+    void run(const std::string &name, const std::function<void()> &body);
+
+    const std::vector<Result> &getResults() const;
+
+    /// Prints a table of the results.
+    void printResults(std::ostream &os) const;
+
+    /// Writes the results as JSON, so that they can be compared between
+    /// builds.
+    void saveToJSON(std::ostream &os) const;
+
+private:
+    Options myOptions;
+    std::vector<Result> myResults;
+};
+
+#endif
@@ -1,3 +1,4 @@
 find_package( Qt5Widgets REQUIRED )
 find_package( Qt5Network REQUIRED )
 find_package( Qt5PrintSupport REQUIRED )
+find_package( Qt5Svg REQUIRED )
@@ -55,11 +55,13 @@ void EditPlayer::redo()
     }
 
     myScore.getPlayers()[myPlayerIndex] = myNewPlayer;
+    myScore.invalidateViewFilters();
 }
 
 void EditPlayer::undo()
 {
     myScore.getPlayers()[myPlayerIndex] = myOriginalPlayer;
+    myScore.invalidateViewFilters();
 
     // Restore the original player changes.
     if (!myOriginalChanges.empty())
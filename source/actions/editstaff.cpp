@@ -66,6 +66,10 @@ void EditStaff::redo()
 
         staff.setStringCount(myNumStrings);
     }
+
+    // Players may have been removed from the staff, which affects the view
+    // filters.
+    myLocation.getScore().invalidatePlayerChanges();
 }
 
 void EditStaff::undo()
@@ -76,6 +80,8 @@ void EditStaff::undo()
 
     if (myOriginalNextSystem)
         score.getSystems()[system_index + 1] = *myOriginalNextSystem;
+
+    score.invalidatePlayerChanges();
 }
 
 void EditStaff::addPlayerChangeAtStart(Score &score, int system_index)
@@ -91,5 +97,14 @@ void EditStaff::addPlayerChangeAtStart(Score &score, int system_index)
         PlayerChange change(*current_players);
         change.setPosition(0);
         system.insertPlayerChange(change);
+        score.invalidatePlayerChanges();
     }
 }
+
+void EditStaff::getMemoryBlocks(
+    std::vector<SystemUtils::MemoryBlock> &blocks) const
+{
+    SystemUtils::getMemoryBlocks(myOriginalSystem, blocks);
+    if (myOriginalNextSystem)
+        SystemUtils::getMemoryBlocks(*myOriginalNextSystem, blocks);
+}
@@ -22,14 +22,17 @@
 #include <QUndoCommand>
 #include <score/scorelocation.h>
 #include <score/system.h>
+#include "undomanager.h"
 
-class EditStaff : public QUndoCommand
+class EditStaff : public QUndoCommand, public UndoMemoryCost
 {
 public:
     EditStaff(const ScoreLocation &location, Staff::ClefType clef, int strings);
 
     virtual void redo() override;
     virtual void undo() override;
+    virtual void getMemoryBlocks(
+        std::vector<SystemUtils::MemoryBlock> &blocks) const override;
 
 private:
     static void addPlayerChangeAtStart(Score &score, int system_index);
@@ -40,3 +40,10 @@ void PolishScore::undo()
 
     myOriginalSystems.clear();
 }
+
+void PolishScore::getMemoryBlocks(
+    std::vector<SystemUtils::MemoryBlock> &blocks) const
+{
+    for (const System &system : myOriginalSystems)
+        SystemUtils::getMemoryBlocks(system, blocks);
+}
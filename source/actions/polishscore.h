@@ -20,16 +20,19 @@
 
 #include <QUndoCommand>
 #include <score/system.h>
+#include "undomanager.h"
 
 class Score;
 
-class PolishScore : public QUndoCommand
+class PolishScore : public QUndoCommand, public UndoMemoryCost
 {
 public:
     PolishScore(Score &score);
 
     virtual void redo() override;
     virtual void undo() override;
+    virtual void getMemoryBlocks(
+        std::vector<SystemUtils::MemoryBlock> &blocks) const override;
 
 private:
     Score &myScore;
@@ -37,3 +37,9 @@ void RemoveStaff::undo()
 {
     myLocation.getSystem().insertStaff(myOriginalStaff, myIndex);
 }
+
+void RemoveStaff::getMemoryBlocks(
+    std::vector<SystemUtils::MemoryBlock> &blocks) const
+{
+    SystemUtils::getMemoryBlocks(myOriginalStaff, blocks);
+}
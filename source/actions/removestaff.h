@@ -21,14 +21,17 @@
 #include <QUndoCommand>
 #include <score/scorelocation.h>
 #include <score/staff.h>
+#include "undomanager.h"
 
-class RemoveStaff : public QUndoCommand
+class RemoveStaff : public QUndoCommand, public UndoMemoryCost
 {
 public:
     RemoveStaff(const ScoreLocation &location);
 
     virtual void redo() override;
     virtual void undo() override;
+    virtual void getMemoryBlocks(
+        std::vector<SystemUtils::MemoryBlock> &blocks) const override;
 
 private:
     ScoreLocation myLocation;
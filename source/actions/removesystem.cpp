@@ -36,3 +36,9 @@ void RemoveSystem::undo()
 {
     myScore.insertSystem(myOriginalSystem, myIndex);
 }
+
+void RemoveSystem::getMemoryBlocks(
+    std::vector<SystemUtils::MemoryBlock> &blocks) const
+{
+    SystemUtils::getMemoryBlocks(myOriginalSystem, blocks);
+}
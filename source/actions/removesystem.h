@@ -20,16 +20,19 @@
 
 #include <QUndoCommand>
 #include <score/system.h>
+#include "undomanager.h"
 
 class Score;
 
-class RemoveSystem : public QUndoCommand
+class RemoveSystem : public QUndoCommand, public UndoMemoryCost
 {
 public:
     RemoveSystem(Score &score, int index);
 
     virtual void redo() override;
     virtual void undo() override;
+    virtual void getMemoryBlocks(
+        std::vector<SystemUtils::MemoryBlock> &blocks) const override;
 
 private:
     Score &myScore;
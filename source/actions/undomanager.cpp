@@ -17,15 +17,230 @@
 
 #include "undomanager.h"
 
-UndoManager::UndoManager(QObject *parent) :
-    QUndoGroup(parent)
+#include <algorithm>
+#include <score/system.h>
+#include <unordered_map>
+#include <util/tracing.h>
+
+const size_t UndoManager::DEFAULT_COMMAND_COST = 512;
+
+/// When a stack exceeds the memory limit, it is compacted to this fraction of
+/// the limit so that the history is not rebuilt after every push.
+static const size_t COMPACT_NUMERATOR = 3;
+static const size_t COMPACT_DENOMINATOR = 4;
+
+/// Tracks the memory used by an undo stack. Blocks of score data that are
+/// shared between several commands' snapshots are only counted once.
+class UndoManager::MemoryUsage
+{
+public:
+    struct Block
+    {
+        size_t mySize;
+        int myRefCount;
+    };
+
+    MemoryUsage() : myTotal(0)
+    {
+    }
+
+    size_t getTotal() const
+    {
+        return myTotal;
+    }
+
+    const Block &getBlock(const void *data) const
+    {
+        return myBlocks.at(data);
+    }
+
+    void add(size_t cost, const std::vector<SystemUtils::MemoryBlock> &blocks)
+    {
+        myTotal += cost;
+
+        for (const SystemUtils::MemoryBlock &block : blocks)
+        {
+            Block &entry = myBlocks[block.myData];
+            if (entry.myRefCount++ == 0)
+            {
+                entry.mySize = block.mySize;
+                myTotal += block.mySize;
+            }
+        }
+
+        Util::Tracing::recordCounter("Undo memory",
+                                     static_cast<int64_t>(myTotal));
+    }
+
+    void remove(size_t cost, const std::vector<const void *> &blocks)
+    {
+        myTotal -= cost;
+
+        for (const void *data : blocks)
+        {
+            auto it = myBlocks.find(data);
+            if (--it->second.myRefCount == 0)
+            {
+                myTotal -= it->second.mySize;
+                myBlocks.erase(it);
+            }
+        }
+    }
+
+private:
+    std::unordered_map<const void *, Block> myBlocks;
+    size_t myTotal;
+};
+
+/// A single entry in the undo history, which runs one or more commands (more
+/// than one for a macro) and then calls each command's redraw callback.
+class UndoManager::Step : public QUndoCommand
+{
+public:
+    Step(const QString &text, const std::shared_ptr<MemoryUsage> &usage)
+        : QUndoCommand(text),
+          myUsage(usage),
+          myCost(0),
+          myHasCost(false),
+          mySkipRedo(false)
+    {
+    }
+
+    ~Step()
+    {
+        myUsage->remove(myCost, myBlocks);
+    }
+
+    void redo() override
+    {
+        Util::Tracing::Span span("actions", "Redo");
+
+        if (mySkipRedo)
+            mySkipRedo = false;
+        else
+        {
+            for (Entry &entry : myCommands)
+            {
+                entry.myCommand->redo();
+                entry.myCallback();
+            }
+
+            // Commands may take new snapshots each time they are redone.
+            myHasCost = false;
+        }
+
+        if (!myHasCost)
+            updateCost();
+    }
+
+    void undo() override
+    {
+        Util::Tracing::Span span("actions", "Undo");
+
+        for (auto it = myCommands.rbegin(); it != myCommands.rend(); ++it)
+        {
+            it->myCommand->undo();
+            it->myCallback();
+        }
+    }
+
+    /// Adds a command to the step. For macros, the command has already been
+    /// run when it is added.
+    void append(QUndoCommand *cmd, const std::function<void()> &callback)
+    {
+        myCommands.push_back({ std::unique_ptr<QUndoCommand>(cmd), callback });
+    }
+
+    /// The commands have already been run, so the next call to redo() (when
+    /// the step is pushed onto a stack) should do nothing.
+    void skipNextRedo()
+    {
+        mySkipRedo = true;
+    }
+
+    /// Returns the fixed cost of the step, excluding its snapshots.
+    size_t getCost() const
+    {
+        return myCost;
+    }
+
+    /// Returns the blocks of score data that the step's snapshots refer to.
+    const std::vector<const void *> &getBlocks() const
+    {
+        return myBlocks;
+    }
+
+    /// Moves the commands into another step, e.g. when the undo history is
+    /// compacted.
+    void moveTo(Step &other)
+    {
+        other.myCommands = std::move(myCommands);
+        other.myCost = myCost;
+        other.myBlocks = std::move(myBlocks);
+        other.myHasCost = myHasCost;
+        myCommands.clear();
+        myCost = 0;
+        myBlocks.clear();
+    }
+
+private:
+    struct Entry
+    {
+        std::unique_ptr<QUndoCommand> myCommand;
+        std::function<void()> myCallback;
+    };
+
+    void updateCost()
+    {
+        size_t cost = 0;
+        std::vector<SystemUtils::MemoryBlock> blocks;
+        for (const Entry &entry : myCommands)
+        {
+            cost += DEFAULT_COMMAND_COST;
+            if (auto snapshot =
+                    dynamic_cast<const UndoMemoryCost *>(entry.myCommand.get()))
+            {
+                snapshot->getMemoryBlocks(blocks);
+            }
+        }
+
+        // Add the new blocks before releasing the old ones, so that blocks
+        // which are still in use are not counted again.
+        myUsage->add(cost, blocks);
+        myUsage->remove(myCost, myBlocks);
+
+        myCost = cost;
+        myHasCost = true;
+        myBlocks.clear();
+        for (const SystemUtils::MemoryBlock &block : blocks)
+            myBlocks.push_back(block.myData);
+    }
+
+    std::vector<Entry> myCommands;
+    std::shared_ptr<MemoryUsage> myUsage;
+    size_t myCost;
+    std::vector<const void *> myBlocks;
+    bool myHasCost;
+    bool mySkipRedo;
+};
+
+UndoManager::UndoManager(QObject *parent)
+    : QUndoGroup(parent), myMacroDepth(0), myMemoryLimit(0)
+{
+}
+
+UndoManager::~UndoManager()
 {
 }
 
 void UndoManager::addNewUndoStack()
 {
-    undoStacks.emplace_back(new QUndoStack);
-    addStack(undoStacks.back().get());
+    UndoStack stack;
+    stack.myStack.reset(new QUndoStack);
+    stack.myUsage = std::make_shared<MemoryUsage>();
+
+    addStack(stack.myStack.get());
+    undoStacks.push_back(std::move(stack));
 }
 
 void UndoManager::setActiveStackIndex(int index)
@@ -33,7 +248,7 @@ void UndoManager::setActiveStackIndex(int index)
     if (index == -1) // When there are no open documents, the index is -1.
         return;
 
-    setActiveStack(undoStacks.at(index).get());
+    setActiveStack(undoStacks.at(index).myStack.get());
 }
 
 void UndoManager::removeStack(int index)
@@ -42,46 +257,45 @@ void UndoManager::removeStack(int index)
     undoStacks.erase(undoStacks.begin() + index);
 }
 
-void UndoManager::push(QUndoCommand *cmd)
+void UndoManager::push(QUndoCommand *cmd, int affectedSystem)
 {
-    activeStack()->push(cmd);
+    push(cmd, affectedSystem, -1);
 }
 
-void UndoManager::push(QUndoCommand *cmd, int affectedSystem)
+void UndoManager::push(QUndoCommand *cmd, int affectedSystem,
+                       int affectedStaff)
 {
-    beginMacro(cmd->actionText());
+    Util::Tracing::Span span("actions", "Push");
 
-    auto onUndo = new SignalOnUndo();
-    if (affectedSystem >= 0)
-    {
-        connect(onUndo, &SignalOnUndo::triggered, [=]() {
-            onSystemChanged(affectedSystem);
-        });
-    }
-    else
+    auto callback = getRedrawCallback(affectedSystem, affectedStaff);
+
+    if (myMacro)
     {
-        connect(onUndo, &SignalOnUndo::triggered, this,
-                &UndoManager::fullRedrawNeeded);
+        cmd->redo();
+        callback();
+        myMacro->append(cmd, callback);
+        return;
     }
 
-    push(onUndo);
-    push(cmd);
+    UndoStack &stack = getActiveStack();
+    auto step = new Step(cmd->actionText(), stack.myUsage);
+    step->append(cmd, callback);
+    stack.myStack->push(step);
+
+    compact(stack);
+}
 
-    auto onRedo = new SignalOnRedo();
-    if (affectedSystem >= 0)
+std::function<void()> UndoManager::getRedrawCallback(int affectedSystem,
+                                                     int affectedStaff)
+{
+    if (affectedSystem >= 0 && affectedStaff >= 0)
     {
-        connect(onRedo, &SignalOnRedo::triggered, [=]() {
-            onSystemChanged(affectedSystem);
-        });
+        return [=]() { emit staffRedrawNeeded(affectedSystem, affectedStaff); };
     }
+    else if (affectedSystem >= 0)
+        return [=]() { emit redrawNeeded(affectedSystem); };
     else
-    {
-        connect(onRedo, &SignalOnRedo::triggered, this,
-                &UndoManager::fullRedrawNeeded);
-    }
-
-    push(onRedo);
-    endMacro();
+        return [=]() { emit fullRedrawNeeded(); };
 }
 
 void UndoManager::setClean()
@@ -89,27 +303,128 @@ void UndoManager::setClean()
     activeStack()->setClean();
 }
 
-void UndoManager::onSystemChanged(int affectedSystem)
+void UndoManager::beginMacro(const QString &text)
 {
-    emit redrawNeeded(affectedSystem);
+    if (myMacroDepth++ == 0)
+        myMacro.reset(new Step(text, getActiveStack().myUsage));
 }
 
-void UndoManager::beginMacro(const QString &text)
+void UndoManager::endMacro()
+{
+    if (--myMacroDepth > 0)
+        return;
+
+    UndoStack &stack = getActiveStack();
+    Step *step = myMacro.release();
+    step->skipNextRedo();
+    stack.myStack->push(step);
+
+    compact(stack);
+}
+
+void UndoManager::setMemoryLimit(size_t bytes)
 {
-    activeStack()->beginMacro(text);
+    myMemoryLimit = bytes;
+
+    for (UndoStack &stack : undoStacks)
+        compact(stack);
 }
 
-void UndoManager::endMacro()
+size_t UndoManager::getMemoryUsage() const
 {
-    activeStack()->endMacro();
+    for (const UndoStack &stack : undoStacks)
+    {
+        if (stack.myStack.get() == activeStack())
+            return stack.myUsage->getTotal();
+    }
+
+    return 0;
 }
 
-void SignalOnRedo::redo()
+UndoManager::UndoStack &UndoManager::getActiveStack()
 {
-    emit triggered();
+    auto it = std::find_if(undoStacks.begin(), undoStacks.end(),
+                           [=](const UndoStack &stack) {
+                               return stack.myStack.get() == activeStack();
+                           });
+    return *it;
 }
 
-void SignalOnUndo::undo()
+void UndoManager::compact(UndoStack &stack)
 {
-    emit triggered();
+    QUndoStack &oldStack = *stack.myStack;
+    const MemoryUsage &usage = *stack.myUsage;
+    if (myMemoryLimit == 0 || usage.getTotal() <= myMemoryLimit)
+        return;
+
+    // Only compact when there is nothing to redo, which is the case right
+    // after a push.
+    const int count = oldStack.count();
+    if (oldStack.index() != count)
+        return;
+
+    // Find the oldest steps that need to be discarded. A block of score data
+    // is only freed once every step that refers to it has been discarded. The
+    // most recent step is always kept.
+    const size_t target =
+        myMemoryLimit / COMPACT_DENOMINATOR * COMPACT_NUMERATOR;
+    std::unordered_map<const void *, int> released;
+    size_t freed = 0;
+    int first = 0;
+    while (first < count - 1 && usage.getTotal() - freed > target)
+    {
+        auto step = static_cast<const Step *>(oldStack.command(first));
+        freed += step->getCost();
+
+        for (const void *data : step->getBlocks())
+        {
+            const MemoryUsage::Block &block = usage.getBlock(data);
+            if (++released[data] == block.myRefCount)
+                freed += block.mySize;
+        }
+
+        ++first;
+    }
+
+    if (first == 0)
+        return;
+
+    // QUndoStack cannot remove commands from the bottom of the stack, so move
+    // the remaining commands to a new stack. Deleting the old stack frees the
+    // discarded commands.
+    std::unique_ptr<QUndoStack> newStack(new QUndoStack);
+
+    // If the saved state was discarded, the new stack must never be clean.
+    // Undoing a placeholder command and then pushing another command clears
+    // the clean state, since QUndoStack::resetClean() requires Qt 5.8.
+    const int cleanIndex = oldStack.cleanIndex() - first;
+    if (cleanIndex < 0)
+    {
+        newStack->push(new QUndoCommand);
+        newStack->setClean();
+        newStack->undo();
+    }
+    else if (cleanIndex == 0)
+        newStack->setClean();
+
+    for (int i = first; i < count; ++i)
+    {
+        auto oldStep =
+            const_cast<Step *>(static_cast<const Step *>(oldStack.command(i)));
+
+        auto step = new Step(oldStep->text(), stack.myUsage);
+        oldStep->moveTo(*step);
+        step->skipNextRedo();
+        newStack->push(step);
+
+        if (i + 1 - first == cleanIndex)
+            newStack->setClean();
+    }
+
+    const bool isActive = activeStack() == &oldStack;
+    addStack(newStack.get());
+    if (isActive)
+        setActiveStack(newStack.get());
+
+    stack.myStack = std::move(newStack);
 }
@@ -18,6 +18,8 @@
 #ifndef ACTIONS_UNDOMANAGER_H
 #define ACTIONS_UNDOMANAGER_H
 
+#include <cstddef>
+#include <functional>
 #include <memory>
 #include <QUndoGroup>
 #include <QUndoStack>
@@ -25,12 +27,31 @@
 
 class QUndoCommand;
 
+namespace SystemUtils {
+struct MemoryBlock;
+}
+
+/// Implemented by undo commands that keep snapshots of the score, so that
+/// their size can be counted against the undo history's memory limit.
+class UndoMemoryCost
+{
+public:
+    virtual ~UndoMemoryCost() {}
+
+    /// Adds the memory used by the command's snapshots. Snapshots share data
+    /// with the score and with each other, so each block is only counted once
+    /// per undo stack.
+    virtual void getMemoryBlocks(
+        std::vector<SystemUtils::MemoryBlock> &blocks) const = 0;
+};
+
 class UndoManager : public QUndoGroup
 {
     Q_OBJECT
 
 public:
     explicit UndoManager(QObject *parent = nullptr);
+    ~UndoManager();
 
     void addNewUndoStack();
     void setActiveStackIndex(int index);
@@ -41,46 +62,59 @@ public:
     /// Use -1 for actions that affect all systems.
     void push(QUndoCommand *cmd, int affectedSystem);
 
+    /// Pushes an undo command that only modifies a single staff, so that the
+    /// rest of the system does not need to be redrawn.
+    void push(QUndoCommand *cmd, int affectedSystem, int affectedStaff);
+
     void setClean();
 
     void beginMacro(const QString &text);
     void endMacro();
 
+    /// Sets the approximate number of bytes that each document's undo history
+    /// may use. When the limit is exceeded, the oldest commands are discarded.
+    /// A limit of 0 disables this.
+    void setMemoryLimit(size_t bytes);
+
+    /// Returns the approximate memory used by the active document's undo
+    /// history.
+    size_t getMemoryUsage() const;
+
     static const int AFFECTS_ALL_SYSTEMS = -1;
+    /// Approximate size of a command that does not report its own cost.
+    static const size_t DEFAULT_COMMAND_COST;
 
 signals:
     void fullRedrawNeeded();
     void redrawNeeded(int);
+    void staffRedrawNeeded(int, int);
 
 private:
-    /// Pushes the QUndoCommand onto the active stack.
-    void push(QUndoCommand *cmd);
-
-    void onSystemChanged(int affectedSystem);
-
-    std::vector<std::unique_ptr<QUndoStack>> undoStacks;
-};
-
-class SignalOnRedo : public QObject, public QUndoCommand
-{
-    Q_OBJECT
-
-public:
-    virtual void redo() override;
-
-signals:
-    void triggered();
-};
-
-class SignalOnUndo: public QObject, public QUndoCommand
-{
-    Q_OBJECT
-
-public:
-    virtual void undo() override;
-
-signals:
-    void triggered();
+    class MemoryUsage;
+    class Step;
+
+    struct UndoStack
+    {
+        std::unique_ptr<QUndoStack> myStack;
+        /// Total cost of the commands in the stack.
+        std::shared_ptr<MemoryUsage> myUsage;
+    };
+
+    /// Returns the function to call after the command is undone or redone.
+    std::function<void()> getRedrawCallback(int affectedSystem,
+                                            int affectedStaff);
+
+    /// If the stack is over the memory limit, discards the oldest commands
+    /// until it is comfortably within the limit.
+    void compact(UndoStack &stack);
+
+    UndoStack &getActiveStack();
+
+    std::vector<UndoStack> undoStacks;
+    /// The macro that is currently being recorded, if any.
+    std::unique_ptr<Step> myMacro;
+    int myMacroDepth;
+    size_t myMemoryLimit;
 };
 
 #endif
@@ -104,16 +104,14 @@ void Caret::moveToStaff(int staff)
     const int end = is_increasing ? num_staves : -1;
 
     const Score &score = myLocation.getScore();
-    const ViewFilter *filter =
-        myViewOptions.getFilter()
-            ? &score.getViewFilters()[*myViewOptions.getFilter()]
-            : nullptr;
+    const boost::optional<int> filter = myViewOptions.getFilter();
 
     // If the specified staff is hidden by the current filter, try the staves
     // before or after in that direction.
     for (int i = staff; i != end; i += increment)
     {
-        if (!filter || filter->accept(score, myLocation.getSystemIndex(), i))
+        if (!filter ||
+            score.isStaffVisible(*filter, myLocation.getSystemIndex(), i))
         {
             myLocation.setStaffIndex(i);
             onLocationChanged();
@@ -66,6 +66,8 @@ public:
 
     /// Add a new, blank document.
     Document &addDocument();
+    /// Add a document that was loaded elsewhere (e.g. on another thread).
+    Document &addDocument(std::unique_ptr<Document> doc);
     /// Add a new document, and initialize it with a staff, player, etc.
     Document &addDefaultDocument(const SettingsManager &settings_manager);
 
@@ -0,0 +1,123 @@
+/*
+  * Copyright (C) 2016 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "importpool.h"
+
+#include <algorithm>
+#include <app/documentmanager.h>
+#include <formats/fileformatmanager.h>
+#include <QRunnable>
+#include <QThread>
+
+/// Imports a single file into a new document.
+class ImportPool::ImportTask : public QRunnable
+{
+public:
+    ImportTask(ImportPool &pool, const std::shared_ptr<Request> &request,
+               const FileFormat &format)
+        : myPool(pool), myRequest(request), myFormat(format)
+    {
+    }
+
+    void run() override
+    {
+        std::unique_ptr<Document> doc(new Document());
+        try
+        {
+            myPool.myFileFormatManager.importFile(
+                doc->getScore(), myRequest->myResult.myFilename, myFormat);
+        }
+        catch (const std::exception &e)
+        {
+            myPool.finishImport(myRequest, nullptr, e.what());
+            return;
+        }
+
+        myPool.finishImport(myRequest, std::move(doc), "");
+    }
+
+private:
+    ImportPool &myPool;
+    const std::shared_ptr<Request> myRequest;
+    const FileFormat myFormat;
+};
+
+ImportPool::ImportPool(FileFormatManager &manager, QObject *parent)
+    : QObject(parent), myFileFormatManager(manager)
+{
+    // Leave a core free for the GUI thread.
+    myThreadPool.setMaxThreadCount(
+        std::max(QThread::idealThreadCount() - 1, 1));
+}
+
+ImportPool::~ImportPool()
+{
+    myThreadPool.clear();
+    myThreadPool.waitForDone();
+}
+
+void ImportPool::import(const std::string &filename, const FileFormat &format)
+{
+    auto request = std::make_shared<Request>();
+    request->myResult.myFilename = filename;
+    request->myIsFinished = false;
+
+    {
+        std::lock_guard<std::mutex> lock(myMutex);
+        myRequests.push_back(request);
+    }
+
+    myThreadPool.start(new ImportTask(*this, request, format));
+}
+
+bool ImportPool::isPending(const std::string &filename) const
+{
+    std::lock_guard<std::mutex> lock(myMutex);
+
+    return std::any_of(myRequests.begin(), myRequests.end(),
+                       [&](const std::shared_ptr<Request> &request) {
+                           return request->myResult.myFilename == filename;
+                       });
+}
+
+std::vector<ImportPool::Result> ImportPool::takeResults()
+{
+    std::lock_guard<std::mutex> lock(myMutex);
+
+    std::vector<Result> results;
+    while (!myRequests.empty() && myRequests.front()->myIsFinished)
+    {
+        results.push_back(std::move(myRequests.front()->myResult));
+        myRequests.pop_front();
+    }
+
+    return results;
+}
+
+void ImportPool::finishImport(const std::shared_ptr<Request> &request,
+                              std::unique_ptr<Document> doc,
+                              const std::string &error)
+{
+    {
+        std::lock_guard<std::mutex> lock(myMutex);
+        request->myResult.myDocument = std::move(doc);
+        request->myResult.myError = error;
+        request->myIsFinished = true;
+    }
+
+    emit importFinished();
+}
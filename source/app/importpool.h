@@ -0,0 +1,88 @@
+/*
+  * Copyright (C) 2016 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef APP_IMPORTPOOL_H
+#define APP_IMPORTPOOL_H
+
+#include <deque>
+#include <formats/fileformat.h>
+#include <memory>
+#include <mutex>
+#include <QObject>
+#include <QThreadPool>
+#include <string>
+#include <vector>
+
+class Document;
+class FileFormatManager;
+
+/// Imports files on background threads, so that the GUI thread isn't blocked
+/// while opening files that were handed off from another instance.
+class ImportPool : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Result
+    {
+        std::string myFilename;
+        /// The imported document, or null if the import failed.
+        std::unique_ptr<Document> myDocument;
+        std::string myError;
+    };
+
+    ImportPool(FileFormatManager &manager, QObject *parent = nullptr);
+    ~ImportPool();
+
+    /// Starts importing the file in the background.
+    void import(const std::string &filename, const FileFormat &format);
+
+    /// Returns whether the file is still waiting to be opened.
+    bool isPending(const std::string &filename) const;
+
+    /// Removes the finished imports, in the order that they were requested.
+    /// An import that finishes early is held back until the earlier
+    /// requests have also finished, so that tabs are opened in order.
+    std::vector<Result> takeResults();
+
+signals:
+    /// Emitted (from a worker thread) when an import has finished.
+    void importFinished();
+
+private:
+    class ImportTask;
+
+    struct Request
+    {
+        Result myResult;
+        bool myIsFinished;
+    };
+
+    /// Records the outcome of an import.
+    void finishImport(const std::shared_ptr<Request> &request,
+                      std::unique_ptr<Document> doc, const std::string &error);
+
+    FileFormatManager &myFileFormatManager;
+
+    /// Guards the list of requests, which is shared with the worker threads.
+    mutable std::mutex myMutex;
+    std::deque<std::shared_ptr<Request>> myRequests;
+
+    QThreadPool myThreadPool;
+};
+
+#endif
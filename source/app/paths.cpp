@@ -64,6 +64,12 @@ std::vector<path> getDataDirs()
     return paths;
 }
 
+path getCacheDir()
+{
+    return fromQString(
+        QStandardPaths::writableLocation(QStandardPaths::CacheLocation));
+}
+
 path getHomeDir()
 {
     return fromQString(
@@ -32,6 +32,10 @@ namespace Paths {
     /// from, ordered from highest to lowest priority.
     std::vector<path> getDataDirs();
 
+    /// Return a path to a directory where non-essential data (which can be
+    /// regenerated) should be written to.
+    path getCacheDir();
+
     /// Return a path to the user's home directory.
     path getHomeDir();
 }
@@ -71,18 +71,21 @@
 #include <actions/removetextitem.h>
 #include <actions/shiftpositions.h>
 #include <actions/undomanager.h>
+#include <algorithm>
 
 #include <app/appinfo.h>
 #include <app/caret.h>
 #include <app/clipboard.h>
 #include <app/command.h>
 #include <app/documentmanager.h>
+#include <app/importpool.h>
 #include <app/paths.h>
 #include <app/pubsub/clickpubsub.h>
 #include <app/recentfiles.h>
 #include <app/scorearea.h>
 #include <app/settings.h>
 #include <app/settingsmanager.h>
+#include <app/startupprofiler.h>
 #include <app/tuningdictionary.h>
 
 #include <audio/midiplayer.h>
@@ -90,7 +93,6 @@
 
 #include <boost/lexical_cast.hpp>
 #include <boost/range/algorithm/transform.hpp>
-#include <chrono>
 
 #include <dialogs/alterationofpacedialog.h>
 #include <dialogs/alternateendingdialog.h>
@@ -136,12 +138,15 @@
 #include <QPrintPreviewDialog>
 #include <QScrollArea>
 #include <QTabBar>
+#include <QTimer>
 #include <QUrl>
 #include <QVBoxLayout>
 
 #include <score/utils.h>
 #include <score/voiceutils.h>
 
+#include <util/tracing.h>
+
 #include <widgets/instruments/instrumentpanel.h>
 #include <widgets/mixer/mixer.h>
 #include <widgets/playback/playbackwidget.h>
@@ -153,7 +158,9 @@ PowerTabEditor::PowerTabEditor()
       myFileFormatManager(new FileFormatManager(*mySettingsManager)),
       myUndoManager(new UndoManager()),
       myTuningDictionary(new TuningDictionary()),
+      myImportPool(new ImportPool(*myFileFormatManager)),
       myIsPlaying(false),
+      myIsCommandUpdatePending(false),
       myRecentFiles(nullptr),
       myActiveDurationType(Position::EighthNote),
       myTabWidget(nullptr),
@@ -175,19 +182,23 @@ PowerTabEditor::PowerTabEditor()
 
     connect(myUndoManager.get(), SIGNAL(redrawNeeded(int)), this,
             SLOT(redrawSystem(int)));
+    connect(myUndoManager.get(), SIGNAL(staffRedrawNeeded(int, int)), this,
+            SLOT(redrawStaff(int, int)));
     connect(myUndoManager.get(), SIGNAL(fullRedrawNeeded()), this,
             SLOT(redrawScore()));
     connect(myUndoManager.get(), SIGNAL(cleanChanged(bool)), this,
             SLOT(updateModified(bool)));
+    connect(myImportPool.get(), &ImportPool::importFinished, this,
+            &PowerTabEditor::openImportedFiles, Qt::QueuedConnection);
 
-    myTuningDictionary->loadInBackground();
     mySettingsManager->load(Paths::getConfigDir());
+    StartupProfiler::markPhase("Load settings");
 
-    createMixer();
-    createInstrumentPanel();
     createCommands();
     loadKeyboardShortcuts();
+    StartupProfiler::markPhase("Create commands");
     createMenus();
+    StartupProfiler::markPhase("Create menus");
 
     // Set up the recent files menu.
     myRecentFiles =
@@ -196,18 +207,59 @@ PowerTabEditor::PowerTabEditor()
             SLOT(openFile(QString)));
 
     createTabArea();
+    StartupProfiler::markPhase("Create tab area");
 
-    auto settings = mySettingsManager->getReadHandle();
-    myPreviousDirectory =
-        QString::fromStdString(settings->get(Settings::PreviousDirectory));
+    bool mixerVisible;
+    bool instrumentPanelVisible;
+    {
+        auto settings = mySettingsManager->getReadHandle();
+        myPreviousDirectory =
+            QString::fromStdString(settings->get(Settings::PreviousDirectory));
+
+        // Restore the state of any dock widgets. The dock widgets are created
+        // later, when they are first shown, and restoreDockWidget() then
+        // places them using the saved state.
+        restoreState(settings->get(Settings::WindowState));
+        mixerVisible = settings->get(Settings::MixerVisible);
+        instrumentPanelVisible =
+            settings->get(Settings::InstrumentPanelVisible);
 
-    // Restore the state of any dock widgets.
-    restoreState(settings->get(Settings::WindowState));
+        myUndoManager->setMemoryLimit(
+            static_cast<size_t>(settings->get(Settings::UndoMemoryLimit)) *
+            1024 * 1024);
+    }
 
     setCentralWidget(myPlaybackArea);
     setMinimumSize(800, 600);
     setWindowState(Qt::WindowMaximized);
     setWindowTitle(getApplicationName());
+    StartupProfiler::markPhase("Restore window state");
+
+    // Hidden dock widgets aren't created until the user shows them.
+    if (mixerVisible)
+        myMixerDockWidgetCommand->trigger();
+    if (instrumentPanelVisible)
+        myInstrumentDockWidgetCommand->trigger();
+    StartupProfiler::markPhase("Create dock widgets");
+
+    // Finish any work that isn't needed for the first frame once the event
+    // loop has started.
+    QTimer::singleShot(0, this, &PowerTabEditor::finishStartup);
+}
+
+void PowerTabEditor::finishStartup()
+{
+    // The tuning dictionary is only needed by the mixer and dialogs, and will
+    // be loaded on demand if it is used before the background load finishes.
+    myTuningDictionary->loadInBackground();
+
+    // Periodically check for background tabs that can be hibernated.
+    auto hibernationTimer = new QTimer(this);
+    connect(hibernationTimer, &QTimer::timeout, this,
+            &PowerTabEditor::hibernateIdleTabs);
+    hibernationTimer->start(60 * 1000);
+
+    StartupProfiler::markPhase("Deferred initialization");
 }
 
 PowerTabEditor::~PowerTabEditor()
@@ -220,6 +272,48 @@ void PowerTabEditor::openFiles(const QStringList &files)
         openFile(filename);
 }
 
+void PowerTabEditor::openFilesInBackground(const QStringList &files)
+{
+    for (const QString &filename : files)
+    {
+        const std::string path = filename.toStdString();
+
+        const int index = myDocumentManager->findDocument(path);
+        if (index > -1)
+        {
+            myTabWidget->setCurrentIndex(index);
+            continue;
+        }
+        else if (myImportPool->isPending(path))
+            continue;
+
+        boost::optional<FileFormat> format = myFileFormatManager->findFormat(
+            QFileInfo(filename).suffix().toStdString());
+        if (!format)
+        {
+            QMessageBox::warning(this, tr("Error Opening File"),
+                                 tr("Unsupported file type."));
+            continue;
+        }
+
+        myImportPool->import(path, *format);
+    }
+}
+
+void PowerTabEditor::warmUp()
+{
+    Util::Tracing::Span span("app", "Warm up");
+
+    myTuningDictionary->ensureLoaded();
+
+    // Render a blank document and then discard it, so that the fonts and
+    // painters are ready before the first file is opened.
+    createNewDocument();
+    closeCurrentTab();
+
+    StartupProfiler::markPhase("Warm up");
+}
+
 void PowerTabEditor::createNewDocument()
 {
     myDocumentManager->addDefaultDocument(*mySettingsManager);
@@ -246,7 +340,7 @@ void PowerTabEditor::openFile(QString filename)
         return;
     }
 
-    auto start = std::chrono::high_resolution_clock::now();
+    Util::Tracing::Span span("app", "Open file");
 
     qDebug() << "Opening file: " << filename;
 
@@ -266,10 +360,6 @@ void PowerTabEditor::openFile(QString filename)
         Document &doc = myDocumentManager->addDocument();
         myFileFormatManager->importFile(doc.getScore(), filename.toStdString(),
                                         *format);
-        auto end = std::chrono::high_resolution_clock::now();
-        qDebug() << "File loaded in"
-                 << std::chrono::duration_cast<std::chrono::milliseconds>(end - start) .count()
-                 << "ms";
 
         doc.setFilename(filename.toStdString());
         setPreviousDirectory(filename);
@@ -287,27 +377,95 @@ void PowerTabEditor::openFile(QString filename)
     }
 }
 
+void PowerTabEditor::openImportedFiles()
+{
+    for (ImportPool::Result &result : myImportPool->takeResults())
+    {
+        const QString filename = QString::fromStdString(result.myFilename);
+        if (!result.myDocument)
+        {
+            QMessageBox::warning(
+                this, tr("Error Opening File"),
+                tr("Error opening file: %1")
+                    .arg(QString::fromStdString(result.myError)));
+            continue;
+        }
+
+        // The file may have been opened some other way during the import.
+        const int index = myDocumentManager->findDocument(result.myFilename);
+        if (index > -1)
+        {
+            myTabWidget->setCurrentIndex(index);
+            continue;
+        }
+
+        Util::Tracing::Span span("app", "Open imported file");
+
+        Document &doc =
+            myDocumentManager->addDocument(std::move(result.myDocument));
+        doc.setFilename(result.myFilename);
+        setPreviousDirectory(filename);
+        myRecentFiles->add(filename);
+        setupNewTab();
+    }
+}
+
 void PowerTabEditor::switchTab(int index)
 {
     myDocumentManager->setCurrentDocumentIndex(index);
 
     if (index != -1)
     {
-        const Document &doc = myDocumentManager->getCurrentDocument();
-        myMixer->reset(doc.getScore());
-        myInstrumentPanel->reset(doc.getScore());
-        myPlaybackWidget->reset(doc);
+        myPlaybackWidget->reset(myDocumentManager->getCurrentDocument());
         updateLocationLabel();
     }
-    else
-    {
-        myMixer->clear();
-        myInstrumentPanel->clear();
-    }
+
+    resetDockWidgets();
 
     myUndoManager->setActiveStackIndex(index);
 
     updateWindowTitle();
+
+    // The previous tab may now exceed the limit on rendered background tabs.
+    hibernateIdleTabs();
+}
+
+void PowerTabEditor::hibernateIdleTabs()
+{
+    auto settings = mySettingsManager->getReadHandle();
+    const qint64 delay =
+        static_cast<qint64>(settings->get(Settings::TabHibernationDelay)) *
+        60 * 1000;
+    const int maxRenderedTabs =
+        settings->get(Settings::MaxRenderedBackgroundTabs);
+
+    // Find the background tabs that are still rendered.
+    std::vector<ScoreArea *> tabs;
+    for (int i = 0; i < myTabWidget->count(); ++i)
+    {
+        auto scorearea = dynamic_cast<ScoreArea *>(myTabWidget->widget(i));
+        if (i != myTabWidget->currentIndex() && scorearea &&
+            !scorearea->isHibernating())
+        {
+            tabs.push_back(scorearea);
+        }
+    }
+
+    // Release the tabs that have been hidden the longest first.
+    std::sort(tabs.begin(), tabs.end(),
+              [](const ScoreArea *a, const ScoreArea *b) {
+                  return a->getHiddenTime() > b->getHiddenTime();
+              });
+
+    const int numTabs = static_cast<int>(tabs.size());
+    for (int i = 0; i < numTabs; ++i)
+    {
+        const bool isIdle = delay > 0 && tabs[i]->getHiddenTime() >= delay;
+        const bool isOverLimit = numTabs - i > maxRenderedTabs;
+
+        if (isIdle || isOverLimit)
+            tabs[i]->hibernate();
+    }
 }
 
 bool PowerTabEditor::closeTab(int index)
@@ -630,6 +788,13 @@ void PowerTabEditor::redrawSystem(int index)
     updateCommands();
 }
 
+void PowerTabEditor::redrawStaff(int systemIndex, int staffIndex)
+{
+    getCaret().moveToValidPosition();
+    getScoreArea()->redrawStaff(systemIndex, staffIndex);
+    updateCommands();
+}
+
 void PowerTabEditor::redrawScore()
 {
     Document &doc = myDocumentManager->getCurrentDocument();
@@ -638,8 +803,7 @@ void PowerTabEditor::redrawScore()
     getScoreArea()->renderDocument(doc);
     updateCommands();
 
-    myMixer->reset(doc.getScore());
-    myInstrumentPanel->reset(doc.getScore());
+    resetDockWidgets();
     myPlaybackWidget->reset(doc);
 }
 
@@ -746,7 +910,8 @@ void PowerTabEditor::shiftBackward()
 void PowerTabEditor::removeNote()
 {
     myUndoManager->push(new RemoveNote(getLocation()),
-                        getLocation().getSystemIndex());
+                        getLocation().getSystemIndex(),
+                        getLocation().getStaffIndex());
 }
 
 void PowerTabEditor::removeSelectedPositions()
@@ -772,7 +937,8 @@ void PowerTabEditor::removeSelectedPositions()
     {
         location.setPositionIndex(position);
         myUndoManager->push(new RemovePosition(location),
-                            location.getSystemIndex());
+                            location.getSystemIndex(),
+                            location.getStaffIndex());
     }
 
     std::vector<int> barPositions;
@@ -914,7 +1080,7 @@ void PowerTabEditor::updateNoteDuration(Position::DurationType duration)
     {
         myUndoManager->push(
             new EditNoteDuration(getLocation(), duration, false),
-            getLocation().getSystemIndex());
+            getLocation().getSystemIndex(), getLocation().getStaffIndex());
     }
     else
         updateCommands();
@@ -970,7 +1136,7 @@ void PowerTabEditor::changeNoteDuration(bool increase)
 
             myUndoManager->push(
                 new EditNoteDuration(location, new_duration, false),
-                location.getSystemIndex());
+                location.getSystemIndex(), location.getStaffIndex());
         }
 
         myUndoManager->endMacro();
@@ -988,14 +1154,16 @@ void PowerTabEditor::addDot()
         myUndoManager->push(new AddPositionProperty(
                                 location, Position::DoubleDotted,
                                 myDoubleDottedCommand->text()),
-                            location.getSystemIndex());
+                            location.getSystemIndex(),
+                            location.getStaffIndex());
     }
     else
     {
         myUndoManager->push(new AddPositionProperty(
                                 location, Position::Dotted,
                                 myDottedCommand->text()),
-                            location.getSystemIndex());
+                            location.getSystemIndex(),
+                            location.getStaffIndex());
     }
 }
 
@@ -1010,14 +1178,16 @@ void PowerTabEditor::removeDot()
         myUndoManager->push(new AddPositionProperty(
                                 location, Position::Dotted,
                                 myDottedCommand->text()),
-                            location.getSystemIndex());
+                            location.getSystemIndex(),
+                            location.getStaffIndex());
     }
     else
     {
         myUndoManager->push(new RemovePositionProperty(
                                 location, Position::Dotted,
                                 myDottedCommand->text()),
-                            location.getSystemIndex());
+                            location.getSystemIndex(),
+                            location.getStaffIndex());
     }
 }
 
@@ -1039,7 +1209,7 @@ void PowerTabEditor::editTiedNote()
             newNote.setProperty(Note::Tied);
             myUndoManager->push(
                 new AddNote(location, newNote, myActiveDurationType),
-                location.getSystemIndex());
+                location.getSystemIndex(), location.getStaffIndex());
         }
         else
             myTieCommand->setChecked(false);
@@ -1095,7 +1265,7 @@ void PowerTabEditor::editIrregularGrouping(bool setAsTriplet)
         {
             myUndoManager->push(
                 new RemoveIrregularGrouping(location, *groups.back()),
-                location.getSystemIndex());
+                location.getSystemIndex(), location.getStaffIndex());
         }
         return;
     }
@@ -1108,7 +1278,8 @@ void PowerTabEditor::editIrregularGrouping(bool setAsTriplet)
         if (setAsTriplet)
         {
             myUndoManager->push(new AddIrregularGrouping(location, group),
-                                location.getSystemIndex());
+                                location.getSystemIndex(),
+                                location.getStaffIndex());
         }
         else
         {
@@ -1119,7 +1290,8 @@ void PowerTabEditor::editIrregularGrouping(bool setAsTriplet)
                 group.setNotesPlayed(dialog.getNotesPlayed());
                 group.setNotesPlayedOver(dialog.getNotesPlayedOver());
                 myUndoManager->push(new AddIrregularGrouping(location, group),
-                                    location.getSystemIndex());
+                                    location.getSystemIndex(),
+                                    location.getStaffIndex());
             }
         }
     }
@@ -1133,7 +1305,7 @@ void PowerTabEditor::addRest()
         pos ? pos->getDurationType() : myActiveDurationType;
 
     myUndoManager->push(new AddRest(location, duration),
-                        location.getSystemIndex());
+                        location.getSystemIndex(), location.getStaffIndex());
 }
 
 void PowerTabEditor::editMultiBarRest()
@@ -1144,7 +1316,7 @@ void PowerTabEditor::editMultiBarRest()
     {
         myUndoManager->push(
             new RemovePosition(location, tr("Remove Multi-Bar Rest")),
-            location.getSystemIndex());
+            location.getSystemIndex(), location.getStaffIndex());
     }
     else
     {
@@ -1178,7 +1350,7 @@ void PowerTabEditor::editMultiBarRest()
         {
             myUndoManager->push(
                 new AddMultiBarRest(location, dialog.getBarCount()),
-                location.getSystemIndex());
+                location.getSystemIndex(), location.getStaffIndex());
         }
         else
             myMultibarRestCommand->setChecked(false);
@@ -1356,7 +1528,8 @@ void PowerTabEditor::editDynamic()
     if (dynamic)
     {
         myUndoManager->push(new RemoveDynamic(location),
-                            location.getSystemIndex());
+                            location.getSystemIndex(),
+                            location.getStaffIndex());
     }
     else
     {
@@ -1367,7 +1540,8 @@ void PowerTabEditor::editDynamic()
                             dialog.getVolumeLevel());
 
             myUndoManager->push(new AddDynamic(location, dynamic),
-                                location.getSystemIndex());
+                                location.getSystemIndex(),
+                                location.getStaffIndex());
         }
         else
             myDynamicCommand->setChecked(false);
@@ -1402,7 +1576,7 @@ void PowerTabEditor::editArtificialHarmonic()
         {
             myUndoManager->push(
                 new AddArtificialHarmonic(location, dialog.getHarmonic()),
-                location.getSystemIndex());
+                location.getSystemIndex(), location.getStaffIndex());
         }
         else
             myArtificialHarmonicCommand->setChecked(false);
@@ -1410,7 +1584,8 @@ void PowerTabEditor::editArtificialHarmonic()
     else
     {
         myUndoManager->push(new RemoveArtificialHarmonic(location),
-                            location.getSystemIndex());
+                            location.getSystemIndex(),
+                            location.getStaffIndex());
     }
 }
 
@@ -1422,7 +1597,8 @@ void PowerTabEditor::editTappedHarmonic()
 
     if (note->hasTappedHarmonic())
         myUndoManager->push(new RemoveTappedHarmonic(location),
-                            location.getSystemIndex());
+                            location.getSystemIndex(),
+                            location.getStaffIndex());
     else
     {
         TappedHarmonicDialog dialog(this, note->getFretNumber());
@@ -1430,7 +1606,8 @@ void PowerTabEditor::editTappedHarmonic()
         {
             myUndoManager->push(new AddTappedHarmonic(location,
                                                       dialog.getTappedFret()),
-                                location.getSystemIndex());
+                                location.getSystemIndex(),
+                                location.getStaffIndex());
         }
         else
             myTappedHarmonicCommand->setChecked(false);
@@ -1446,7 +1623,8 @@ void PowerTabEditor::editBend()
     if (note->hasBend())
     {
         myUndoManager->push(new RemoveBend(location),
-                            location.getSystemIndex());
+                            location.getSystemIndex(),
+                            location.getStaffIndex());
     }
     else
     {
@@ -1454,7 +1632,8 @@ void PowerTabEditor::editBend()
         if (dialog.exec() == QDialog::Accepted)
         {
             myUndoManager->push(new AddBend(location, dialog.getBend()),
-                                location.getSystemIndex());
+                                location.getSystemIndex(),
+                                location.getStaffIndex());
         }
         else
             myBendCommand->setChecked(false);
@@ -1468,14 +1647,17 @@ void PowerTabEditor::editTrill()
     Q_ASSERT(note);
 
     if (note->hasTrill())
-        myUndoManager->push(new RemoveTrill(location), location.getSystemIndex());
+        myUndoManager->push(new RemoveTrill(location),
+                            location.getSystemIndex(),
+                            location.getStaffIndex());
     else
     {
         TrillDialog dialog(this, note->getFretNumber());
         if (dialog.exec() == QDialog::Accepted)
         {
             myUndoManager->push(new AddTrill(location, dialog.getTrilledFret()),
-                                location.getSystemIndex());
+                                location.getSystemIndex(),
+                                location.getStaffIndex());
         }
         else
             myTrillCommand->setChecked(false);
@@ -1600,7 +1782,10 @@ void PowerTabEditor::editPlayer(int playerIndex, const Player &player,
     ScoreLocation &location = getLocation();
 
     if (!undoable)
+    {
         location.getScore().getPlayers()[playerIndex] = player;
+        location.getScore().invalidateViewFilters();
+    }
     else
     {
         myUndoManager->push(
@@ -1673,7 +1858,8 @@ bool PowerTabEditor::eventFilter(QObject *object, QEvent *event)
                 if (location.getNote())
                 {
                     myUndoManager->push(new EditTabNumber(location, number),
-                                        location.getSystemIndex());
+                                        location.getSystemIndex(),
+                                        location.getStaffIndex());
                 }
                 else
                 {
@@ -1681,7 +1867,8 @@ bool PowerTabEditor::eventFilter(QObject *object, QEvent *event)
                                 new AddNote(location,
                                             Note(location.getString(), number),
                                             myActiveDurationType),
-                                location.getSystemIndex());
+                                location.getSystemIndex(),
+                                location.getStaffIndex());
                 }
 
                 return true;
@@ -1709,6 +1896,10 @@ void PowerTabEditor::closeEvent(QCloseEvent *event)
     {
         auto settings = mySettingsManager->getWriteHandle();
         settings->set(Settings::WindowState, saveState());
+        settings->set(Settings::MixerVisible,
+                      myMixerDockWidgetCommand->isChecked());
+        settings->set(Settings::InstrumentPanelVisible,
+                      myInstrumentDockWidgetCommand->isChecked());
     }
 
     mySettingsManager->save(Paths::getConfigDir());
@@ -2482,12 +2673,25 @@ void PowerTabEditor::createCommands()
         QDesktopServices::openUrl(QUrl(AppInfo::BUG_TRACKER_URL));
     });
 
-    myMixerDockWidgetCommand =
-        createCommandWrapper(myMixerDockWidget->toggleViewAction(),
-                             "Window.Mixer", QKeySequence(), this);
-    myInstrumentDockWidgetCommand =
-        createCommandWrapper(myInstrumentDockWidget->toggleViewAction(),
-                             "Window.Instruments", QKeySequence(), this);
+    // The dock widgets are created the first time that they are shown.
+    myMixerDockWidgetCommand = new Command(tr("Mixer"), "Window.Mixer",
+                                           QKeySequence(), this);
+    myMixerDockWidgetCommand->setCheckable(true);
+    connect(myMixerDockWidgetCommand, &QAction::triggered, [=](bool checked) {
+        if (!myMixerDockWidget)
+            createMixer();
+        myMixerDockWidget->setVisible(checked);
+    });
+
+    myInstrumentDockWidgetCommand = new Command(
+        tr("Instruments"), "Window.Instruments", QKeySequence(), this);
+    myInstrumentDockWidgetCommand->setCheckable(true);
+    connect(myInstrumentDockWidgetCommand, &QAction::triggered,
+            [=](bool checked) {
+        if (!myInstrumentDockWidget)
+            createInstrumentPanel();
+        myInstrumentDockWidget->setVisible(checked);
+    });
 }
 
 void PowerTabEditor::loadKeyboardShortcuts()
@@ -2531,6 +2735,11 @@ void PowerTabEditor::createMixer()
     scroll->setWidget(myMixer);
     myMixerDockWidget->setWidget(scroll);
     addDockWidget(Qt::BottomDockWidgetArea, myMixerDockWidget);
+    restoreDockWidget(myMixerDockWidget);
+
+    // Closing the dock widget unchecks the command.
+    connect(myMixerDockWidget->toggleViewAction(), &QAction::toggled,
+            myMixerDockWidgetCommand, &QAction::setChecked);
 
     myPlayerEditPubSub.subscribe([=](int index, const Player & player,
                                  bool undoable) {
@@ -2539,6 +2748,8 @@ void PowerTabEditor::createMixer()
     myPlayerRemovePubSub.subscribe([=](int index) {
         removePlayer(index);
     });
+
+    resetDockWidgets();
 }
 
 void PowerTabEditor::createInstrumentPanel()
@@ -2557,6 +2768,10 @@ void PowerTabEditor::createInstrumentPanel()
     scroll->setWidget(myInstrumentPanel);
     myInstrumentDockWidget->setWidget(scroll);
     addDockWidget(Qt::BottomDockWidgetArea, myInstrumentDockWidget);
+    restoreDockWidget(myInstrumentDockWidget);
+
+    connect(myInstrumentDockWidget->toggleViewAction(), &QAction::toggled,
+            myInstrumentDockWidgetCommand, &QAction::setChecked);
 
     myInstrumentEditPubSub.subscribe([=](int index, const Instrument &instrument) {
         editInstrument(index, instrument);
@@ -2564,21 +2779,31 @@ void PowerTabEditor::createInstrumentPanel()
     myInstrumentRemovePubSub.subscribe([=](int index) {
         removeInstrument(index);
     });
+
+    resetDockWidgets();
 }
 
-Command *PowerTabEditor::createCommandWrapper(
-    QAction *action, const QString &id, const QKeySequence &defaultShortcut,
-    QObject *parent)
+void PowerTabEditor::resetDockWidgets()
 {
-    Command *command = new Command(action->text(), id, defaultShortcut, parent);
-    command->setCheckable(action->isCheckable());
-    command->setChecked(action->isChecked());
+    const Score *score = nullptr;
+    if (myDocumentManager->hasOpenDocuments())
+        score = &myDocumentManager->getCurrentDocument().getScore();
 
-    // Keep the two actions in sync with each other.
-    connect(command, &QAction::triggered, action, &QAction::triggered);
-    connect(action, &QAction::toggled, command, &QAction::setChecked);
+    if (myMixer)
+    {
+        if (score)
+            myMixer->reset(*score);
+        else
+            myMixer->clear();
+    }
 
-    return command;
+    if (myInstrumentPanel)
+    {
+        if (score)
+            myInstrumentPanel->reset(*score);
+        else
+            myInstrumentPanel->clear();
+    }
 }
 
 void PowerTabEditor::createNoteDurationCommand(
@@ -2878,8 +3103,8 @@ void PowerTabEditor::createTabArea()
     connect(myPlaybackWidget, &PlaybackWidget::activeFilterChanged, this,
             &PowerTabEditor::updateActiveFilter);
 
-    connect(myPlaybackWidget, &PlaybackWidget::zoomChanged,
-            [&](double percent) { getScoreArea()->zoomTo(percent); });
+    connect(myPlaybackWidget, &PlaybackWidget::zoomChanged, this,
+            &PowerTabEditor::updateZoom);
 
     auto update_metronome_state = [&]() {
         auto settings = mySettingsManager->getReadHandle();
@@ -2913,14 +3138,13 @@ void PowerTabEditor::setPreviousDirectory(const QString &fileName)
 
 void PowerTabEditor::setupNewTab()
 {
-    auto start = std::chrono::high_resolution_clock::now();
-    qDebug() << "Tab creation started ...";
+    Util::Tracing::Span span("app", "Set up tab");
 
     Q_ASSERT(myDocumentManager->hasOpenDocuments());
     Document &doc = myDocumentManager->getCurrentDocument();
 
     doc.getCaret().subscribeToChanges([=]() {
-        updateCommands();
+        scheduleCommandUpdate();
         updateLocationLabel();
     });
 
@@ -2986,8 +3210,7 @@ void PowerTabEditor::setupNewTab()
     const int tabIndex = myTabWidget->addTab(scorearea, title);
     myTabWidget->setTabToolTip(tabIndex, fileInfo.fileName());
 
-    myMixer->reset(doc.getScore());
-    myInstrumentPanel->reset(doc.getScore());
+    resetDockWidgets();
     myPlaybackWidget->reset(doc);
 
     // Switch to the new document.
@@ -2997,11 +3220,6 @@ void PowerTabEditor::setupNewTab()
     enableEditing(true);
     updateCommands();
     scorearea->setFocus();
-
-    auto end = std::chrono::high_resolution_clock::now();
-    qDebug() << "Tab opened in"
-             << std::chrono::duration_cast<std::chrono::milliseconds>(
-                    end - start).count() << "ms";
 }
 
 namespace
@@ -3021,19 +3239,74 @@ inline void updateNoteProperty(Command *command, const Note *note,
 }
 }
 
+bool PowerTabEditor::CommandInputs::isSameSystem(
+    const CommandInputs &other) const
+{
+    return myIsPlaying == other.myIsPlaying && myScore == other.myScore &&
+           mySystem == other.mySystem;
+}
+
+bool PowerTabEditor::CommandInputs::isSamePosition(
+    const CommandInputs &other) const
+{
+    return isSameSystem(other) && myStaff == other.myStaff &&
+           myVoice == other.myVoice && myPosition == other.myPosition &&
+           mySelectionStart == other.mySelectionStart;
+}
+
+bool PowerTabEditor::CommandInputs::operator==(
+    const CommandInputs &other) const
+{
+    return isSamePosition(other) && myString == other.myString;
+}
+
 void PowerTabEditor::updateCommands()
 {
+    // The score or the editor's state may have changed, so the next update
+    // can't be skipped.
+    myCommandInputs.reset();
+    scheduleCommandUpdate();
+}
+
+void PowerTabEditor::scheduleCommandUpdate()
+{
+    if (myIsCommandUpdatePending)
+        return;
+
+    myIsCommandUpdatePending = true;
+    QMetaObject::invokeMethod(this, "refreshCommands", Qt::QueuedConnection);
+}
+
+void PowerTabEditor::refreshCommands()
+{
+    Util::Tracing::Span span("app", "Update commands");
+    myIsCommandUpdatePending = false;
+
+    // The last document may have been closed before the update ran.
+    if (!myDocumentManager->hasOpenDocuments())
+    {
+        myCommandInputs.reset();
+        return;
+    }
+
     // Disable editing during playback.
     if (myIsPlaying)
     {
-        enableEditing(false);
-        myPlayPauseCommand->setEnabled(true);
-        myRewindCommand->setEnabled(true);
-        myMetronomeCommand->setEnabled(true);
+        if (!myCommandInputs || !myCommandInputs->myIsPlaying)
+        {
+            enableEditing(false);
+            myPlayPauseCommand->setEnabled(true);
+            myRewindCommand->setEnabled(true);
+            myMetronomeCommand->setEnabled(true);
+        }
+
+        CommandInputs inputs = CommandInputs();
+        inputs.myIsPlaying = true;
+        myCommandInputs = inputs;
         return;
     }
 
-    ScoreLocation location = getLocation();
+    ScoreLocation &location = getLocation();
     const Score &score = location.getScore();
     if (score.getSystems().empty())
         return;
@@ -3042,28 +3315,64 @@ void PowerTabEditor::updateCommands()
     if (system.getStaves().empty())
         return;
 
+    CommandInputs inputs;
+    inputs.myIsPlaying = false;
+    inputs.myScore = &score;
+    inputs.mySystem = location.getSystemIndex();
+    inputs.myStaff = location.getStaffIndex();
+    inputs.myVoice = location.getVoiceIndex();
+    inputs.myPosition = location.getPositionIndex();
+    inputs.mySelectionStart = location.getSelectionStart();
+    inputs.myString = location.getString();
+
+    if (myCommandInputs && *myCommandInputs == inputs)
+        return;
+
+    // Only update the groups of commands whose inputs changed. For example,
+    // moving the caret up or down only changes the current note.
+    const bool systemChanged =
+        !myCommandInputs || !myCommandInputs->isSameSystem(inputs);
+    const bool positionChanged =
+        !myCommandInputs || !myCommandInputs->isSamePosition(inputs);
+    myCommandInputs = inputs;
+
+    if (systemChanged)
+        updateSystemCommands(score, system);
+    if (positionChanged)
+        updatePositionCommands(location);
+
+    updateNoteCommands(location.getNote(), location.getBarline() != nullptr);
+}
+
+void PowerTabEditor::updateSystemCommands(const Score &score,
+                                          const System &system)
+{
+    myRemoveCurrentSystemCommand->setEnabled(score.getSystems().size() > 1);
+    myRemoveCurrentStaffCommand->setEnabled(system.getStaves().size() > 1);
+    myIncreaseLineSpacingCommand->setEnabled(score.getLineSpacing() <
+                                             Score::MAX_LINE_SPACING);
+    myDecreaseLineSpacingCommand->setEnabled(score.getLineSpacing() >
+                                             Score::MIN_LINE_SPACING);
+}
+
+void PowerTabEditor::updatePositionCommands(const ScoreLocation &location)
+{
+    const System &system = location.getSystem();
     const Staff &staff = location.getStaff();
+    const Barline *barline = location.getBarline();
     const Position *pos = location.getPosition();
     const int position = location.getPositionIndex();
-    const Note *note = location.getNote();
-    const Barline *barline = location.getBarline();
     const TempoMarker *tempoMarker =
         ScoreUtils::findByPosition(system.getTempoMarkers(), position);
     const AlternateEnding *altEnding =
         ScoreUtils::findByPosition(system.getAlternateEndings(), position);
     const Dynamic *dynamic =
         ScoreUtils::findByPosition(staff.getDynamics(), position);
-    const bool hasSelection = !location.getSelectedPositions().empty();
+    const bool hasSelection =
+        location.hasSelection() && !location.getSelectedPositions().empty();
 
-    myRemoveCurrentSystemCommand->setEnabled(score.getSystems().size() > 1);
-    myRemoveCurrentStaffCommand->setEnabled(system.getStaves().size() > 1);
-    myIncreaseLineSpacingCommand->setEnabled(score.getLineSpacing() <
-                                             Score::MAX_LINE_SPACING);
-    myDecreaseLineSpacingCommand->setEnabled(score.getLineSpacing() >
-                                             Score::MIN_LINE_SPACING);
     myShiftBackwardCommand->setEnabled(!pos && (position == 0 || !barline) &&
                                        !tempoMarker && !altEnding && !dynamic);
-    myRemoveNoteCommand->setEnabled(note != nullptr);
     myRemovePositionCommand->setEnabled(pos || barline || hasSelection);
 
     myChordNameCommand->setChecked(
@@ -3113,23 +3422,6 @@ void PowerTabEditor::updateCommands()
                                    (pos->hasProperty(Position::Dotted) ||
                                     pos->hasProperty(Position::DoubleDotted)));
 
-    if (note)
-    {
-        myTieCommand->setText(tr("Tied"));
-        myTieCommand->setChecked(note->hasProperty(Note::Tied));
-        myTieCommand->setEnabled(true);
-    }
-    else if (!barline)
-    {
-        myTieCommand->setText(tr("Insert Tied Note"));
-        myTieCommand->setChecked(false);
-        myTieCommand->setEnabled(true);
-    }
-    else
-        myTieCommand->setEnabled(false);
-
-    updateNoteProperty(myMutedCommand, note, Note::Muted);
-    updateNoteProperty(myGhostNoteCommand, note, Note::GhostNote);
     updatePositionProperty(myLetRingCommand, pos, Position::LetRing);
     updatePositionProperty(myFermataCommand, pos, Position::Fermata);
     updatePositionProperty(myGraceNoteCommand, pos, Position::Acciaccatura);
@@ -3137,11 +3429,6 @@ void PowerTabEditor::updateCommands()
     updatePositionProperty(myMarcatoCommand, pos, Position::Marcato);
     updatePositionProperty(mySforzandoCommand, pos, Position::Sforzando);
 
-    updateNoteProperty(myOctave8vaCommand, note, Note::Octave8va);
-    updateNoteProperty(myOctave8vbCommand, note, Note::Octave8vb);
-    updateNoteProperty(myOctave15maCommand, note, Note::Octave15ma);
-    updateNoteProperty(myOctave15mbCommand, note, Note::Octave15mb);
-
     myAddRestCommand->setEnabled(!pos || !pos->isRest());
 
     myTripletCommand->setEnabled(pos != nullptr);
@@ -3186,6 +3473,50 @@ void PowerTabEditor::updateCommands()
         myBarlineCommand->setText(tr("Barline"));
     }
 
+    updatePositionProperty(myVibratoCommand, pos, Position::Vibrato);
+    updatePositionProperty(myWideVibratoCommand, pos, Position::WideVibrato);
+    updatePositionProperty(myPalmMuteCommand, pos, Position::PalmMuting);
+    updatePositionProperty(myTremoloPickingCommand, pos,
+                           Position::TremoloPicking);
+    updatePositionProperty(myTapCommand, pos, Position::Tap);
+    updatePositionProperty(myArpeggioUpCommand, pos, Position::ArpeggioUp);
+    updatePositionProperty(myArpeggioDownCommand, pos, Position::ArpeggioDown);
+    updatePositionProperty(myPickStrokeUpCommand, pos, Position::PickStrokeUp);
+    updatePositionProperty(myPickStrokeDownCommand, pos,
+                           Position::PickStrokeDown);
+
+    myPlayerChangeCommand->setChecked(
+        ScoreUtils::findByPosition(system.getPlayerChanges(), position) !=
+        nullptr);
+}
+
+void PowerTabEditor::updateNoteCommands(const Note *note, bool isBarline)
+{
+    myRemoveNoteCommand->setEnabled(note != nullptr);
+
+    if (note)
+    {
+        myTieCommand->setText(tr("Tied"));
+        myTieCommand->setChecked(note->hasProperty(Note::Tied));
+        myTieCommand->setEnabled(true);
+    }
+    else if (!isBarline)
+    {
+        myTieCommand->setText(tr("Insert Tied Note"));
+        myTieCommand->setChecked(false);
+        myTieCommand->setEnabled(true);
+    }
+    else
+        myTieCommand->setEnabled(false);
+
+    updateNoteProperty(myMutedCommand, note, Note::Muted);
+    updateNoteProperty(myGhostNoteCommand, note, Note::GhostNote);
+
+    updateNoteProperty(myOctave8vaCommand, note, Note::Octave8va);
+    updateNoteProperty(myOctave8vbCommand, note, Note::Octave8vb);
+    updateNoteProperty(myOctave15maCommand, note, Note::Octave15ma);
+    updateNoteProperty(myOctave15mbCommand, note, Note::Octave15mb);
+
     myHammerPullCommand->setEnabled(note != nullptr);
     myHammerPullCommand->setChecked(note &&
                                     note->hasProperty(Note::HammerOnOrPullOff));
@@ -3214,23 +3545,8 @@ void PowerTabEditor::updateCommands()
     updateNoteProperty(mySlideOutOfUpwardsCommand, note,
                        Note::SlideOutOfUpwards);
 
-    updatePositionProperty(myVibratoCommand, pos, Position::Vibrato);
-    updatePositionProperty(myWideVibratoCommand, pos, Position::WideVibrato);
-    updatePositionProperty(myPalmMuteCommand, pos, Position::PalmMuting);
-    updatePositionProperty(myTremoloPickingCommand, pos,
-                           Position::TremoloPicking);
     myTrillCommand->setEnabled(note != nullptr);
     myTrillCommand->setChecked(note && note->hasTrill());
-    updatePositionProperty(myTapCommand, pos, Position::Tap);
-    updatePositionProperty(myArpeggioUpCommand, pos, Position::ArpeggioUp);
-    updatePositionProperty(myArpeggioDownCommand, pos, Position::ArpeggioDown);
-    updatePositionProperty(myPickStrokeUpCommand, pos, Position::PickStrokeUp);
-    updatePositionProperty(myPickStrokeDownCommand, pos,
-                           Position::PickStrokeDown);
-
-    myPlayerChangeCommand->setChecked(
-        ScoreUtils::findByPosition(system.getPlayerChanges(), position) !=
-        nullptr);
 }
 
 void PowerTabEditor::enableEditing(bool enable)
@@ -3278,13 +3594,15 @@ void PowerTabEditor::editRest(Position::DurationType duration)
         else
         {
             myUndoManager->push(new EditNoteDuration(location, duration, true),
-                                location.getSystemIndex());
+                                location.getSystemIndex(),
+                                location.getStaffIndex());
         }
     }
     else
     {
         myUndoManager->push(new AddRest(location, duration),
-                            location.getSystemIndex());
+                            location.getSystemIndex(),
+                            location.getStaffIndex());
 
     }
 }
@@ -3321,6 +3639,28 @@ void PowerTabEditor::updateActiveFilter(int filter)
     redrawScore();
 }
 
+void PowerTabEditor::updateZoom(double percent)
+{
+    getScoreArea()->zoomTo(percent);
+
+    ViewOptions::DetailLevel level = ViewOptions::DetailLevel::Full;
+    {
+        auto settings = mySettingsManager->getReadHandle();
+        if (percent < settings->get(Settings::OverviewDetailZoom))
+            level = ViewOptions::DetailLevel::Overview;
+        else if (percent < settings->get(Settings::ReducedDetailZoom))
+            level = ViewOptions::DetailLevel::Reduced;
+    }
+
+    ViewOptions &options =
+        myDocumentManager->getCurrentDocument().getViewOptions();
+    if (level != options.getDetailLevel())
+    {
+        options.setDetailLevel(level);
+        redrawScore();
+    }
+}
+
 void PowerTabEditor::updateLocationLabel()
 {
     myPlaybackWidget->updateLocationLabel(
@@ -3413,7 +3753,7 @@ void PowerTabEditor::editClef(int system, int staff)
 
     myUndoManager->push(
         new EditStaff(location, newClef, currentStaff.getStringCount()),
-        location.getSystemIndex());
+        location.getSystemIndex(), location.getStaffIndex());
 }
 
 void PowerTabEditor::editSimplePositionProperty(Command *command,
@@ -3437,13 +3777,15 @@ void PowerTabEditor::editSimplePositionProperty(Command *command,
     {
         myUndoManager->push(new AddPositionProperty(location, property,
                                                     command->text()),
-                            location.getSystemIndex());
+                            location.getSystemIndex(),
+                            location.getStaffIndex());
     }
     else
     {
         myUndoManager->push(new RemovePositionProperty(location, property,
                                                        command->text()),
-                            location.getSystemIndex());
+                            location.getSystemIndex(),
+                            location.getStaffIndex());
     }
 }
 
@@ -3468,13 +3810,15 @@ void PowerTabEditor::editSimpleNoteProperty(Command *command,
     {
         myUndoManager->push(new AddNoteProperty(location, property,
                                                 command->text()),
-                            location.getSystemIndex());
+                            location.getSystemIndex(),
+                            location.getStaffIndex());
     }
     else
     {
         myUndoManager->push(new RemoveNoteProperty(location, property,
                                                    command->text()),
-                            location.getSystemIndex());
+                            location.getSystemIndex(),
+                            location.getStaffIndex());
     }
 }
 
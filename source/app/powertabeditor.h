@@ -22,6 +22,7 @@
 
 #include <app/pubsub/instrumentpubsub.h>
 #include <app/pubsub/playerpubsub.h>
+#include <boost/optional/optional.hpp>
 #include <memory>
 #include <score/position.h>
 #include <string>
@@ -31,15 +32,19 @@ class Caret;
 class Command;
 class DocumentManager;
 class FileFormatManager;
+class ImportPool;
 class InstrumentPanel;
 class MidiPlayer;
 class Mixer;
+class Note;
 class PlaybackWidget;
 class QActionGroup;
 class RecentFiles;
+class Score;
 class ScoreArea;
 class ScoreLocation;
 class SettingsManager;
+class System;
 class TuningDictionary;
 class UndoManager;
 
@@ -54,14 +59,39 @@ public:
     /// Opens the given list of files.
     void openFiles(const QStringList &files);
 
+    /// Opens the files once they have been imported on a background thread,
+    /// e.g. for files that are handed off from another instance.
+    void openFilesInBackground(const QStringList &files);
+
+    /// Loads the resources that are needed to open a file (fonts, the tuning
+    /// dictionary, etc) ahead of time, for an instance that is started
+    /// before any files are opened.
+    void warmUp();
+
 private slots:
     /// Creates a new (blank) document.
     void createNewDocument();
 
+    /// Releases the rendered scores of background tabs that have been idle
+    /// for too long, or that exceed the limit on rendered tabs.
+    void hibernateIdleTabs();
+
+    /// Performs any initialization that can be deferred until after the
+    /// window is shown.
+    void finishStartup();
+
+    /// Updates the state of the commands for the current location. This is
+    /// invoked from the event loop by updateCommands().
+    void refreshCommands();
+
     /// Opens a new file. If 'filename' is empty, the user will be prompted
     /// to select a filename.
     void openFile(QString filename = "");
 
+    /// Opens tabs for any files that have finished importing in the
+    /// background.
+    void openImportedFiles();
+
     /// Handle when the active tab is changed.
     void switchTab(int index);
 
@@ -121,6 +151,8 @@ private slots:
 
     /// Redraws only the given system.
     void redrawSystem(int);
+    /// Redraws a single staff in the given system.
+    void redrawStaff(int, int);
     /// Redraws the entire score.
     void redrawScore();
 
@@ -280,10 +312,14 @@ private:
 
     /// Create all of the commands for the application.
     void createCommands();
-    /// Build the mixer widget.
+    /// Build the mixer widget. This is done when the mixer is first shown, and
+    /// restores any saved position of the dock widget.
     void createMixer();
-    /// Build the instrument panel.
+    /// Build the instrument panel. This is done when the panel is first shown.
     void createInstrumentPanel();
+    /// Updates the mixer and instrument panel (if they have been created) for
+    /// the active document.
+    void resetDockWidgets();
 
     /// Load any custom keyboard shortcuts.
     void loadKeyboardShortcuts();
@@ -293,11 +329,6 @@ private:
     std::vector<const Command *> getCommands() const;
     std::vector<Command *> getCommands();
 
-    /// Helper function to create a wrapper around QAction that supports
-    /// customizable shortcuts.
-    static Command *createCommandWrapper(QAction *action, const QString &id,
-                                         const QKeySequence &defaultShortcut,
-                                         QObject *parent);
     /// Helper function to create a note duration command.
     void createNoteDurationCommand(Command *&command, const QString &menuName,
                                    const QString &commandName,
@@ -327,9 +358,19 @@ private:
     void setPreviousDirectory(const QString &fileName);
     /// Sets up the UI for the current document after it has been opened.
     void setupNewTab();
-    /// Updates whether menu items are enabled, checked, etc. depending on the
-    /// current location.
+    /// Updates whether menu items are enabled, checked, etc. after the score
+    /// or the editor's state has changed. The update is deferred, so that
+    /// multiple requests in the same event loop iteration are merged.
     void updateCommands();
+    /// Schedules an update of the commands after the caret moves. Nothing is
+    /// done if the caret's location did not actually change.
+    void scheduleCommandUpdate();
+    /// Updates the commands that only depend on the current system.
+    void updateSystemCommands(const Score &score, const System &system);
+    /// Updates the commands that depend on the current position or selection.
+    void updatePositionCommands(const ScoreLocation &location);
+    /// Updates the commands that only depend on the current note.
+    void updateNoteCommands(const Note *note, bool isBarline);
     /// Enables or disables all editing commands.
     void enableEditing(bool enable);
 
@@ -341,6 +382,9 @@ private:
     void updateActiveVoice(int);
     /// Sets the current score filter.
     void updateActiveFilter(int);
+    /// Zooms the score area, and redraws the score if the zoom level crosses
+    /// one of the level of detail thresholds.
+    void updateZoom(double percent);
     /// Updates the playback widget with the caret's current location.
     void updateLocationLabel();
 
@@ -382,18 +426,42 @@ private:
     /// Returns the location of the caret within the active document.
     ScoreLocation &getLocation();
 
+    /// The inputs that the state of the commands was computed from.
+    struct CommandInputs
+    {
+        /// Returns whether the system commands can be reused.
+        bool isSameSystem(const CommandInputs &other) const;
+        /// Returns whether the position commands can be reused.
+        bool isSamePosition(const CommandInputs &other) const;
+        bool operator==(const CommandInputs &other) const;
+
+        bool myIsPlaying;
+        const Score *myScore;
+        int mySystem;
+        int myStaff;
+        int myVoice;
+        int myPosition;
+        int mySelectionStart;
+        int myString;
+    };
+
     std::unique_ptr<SettingsManager> mySettingsManager;
     std::unique_ptr<DocumentManager> myDocumentManager;
     std::unique_ptr<FileFormatManager> myFileFormatManager;
     std::unique_ptr<UndoManager> myUndoManager;
     std::unique_ptr<MidiPlayer> myMidiPlayer;
     std::unique_ptr<TuningDictionary> myTuningDictionary;
+    std::unique_ptr<ImportPool> myImportPool;
     PlayerEditPubSub myPlayerEditPubSub;
     PlayerRemovePubSub myPlayerRemovePubSub;
     InstrumentEditPubSub myInstrumentEditPubSub;
     InstrumentRemovePubSub myInstrumentRemovePubSub;
     /// Tracks whether we are currently in playback mode.
     bool myIsPlaying;
+    bool myIsCommandUpdatePending;
+    /// The inputs from the last update of the commands, or nothing if the
+    /// commands need a full update.
+    boost::optional<CommandInputs> myCommandInputs;
     /// Tracks the last directory that a file was opened from.
     QString myPreviousDirectory;
     RecentFiles *myRecentFiles;
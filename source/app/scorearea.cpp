@@ -17,21 +17,42 @@
   
 #include "scorearea.h"
 
+#include <algorithm>
 #include <app/documentmanager.h>
 #include <app/pubsub/clickpubsub.h>
-#include <chrono>
 #include <future>
 #include <painters/caretpainter.h>
+#include <painters/staffpainter.h>
 #include <painters/systemrenderer.h>
 #include <QDebug>
+#include <QGraphicsEffect>
 #include <QGraphicsItem>
 #include <QGraphicsSceneDragDropEvent>
+#include <QHideEvent>
+#include <QMouseEvent>
+#include <QPicture>
 #include <QPrinter>
 #include <QScrollBar>
+#include <QShowEvent>
 #include <score/score.h>
+#include <util/tracing.h>
 
 static const double SYSTEM_SPACING = 50;
 
+namespace
+{
+/// Skips painting a system's items, which are drawn from the tile cache
+/// instead. Unlike hiding the items or making them transparent, this leaves
+/// them available for hit-testing, hover events, and tooltips.
+class SuppressPaintingEffect : public QGraphicsEffect
+{
+protected:
+    void draw(QPainter *) override
+    {
+    }
+};
+}
+
 void ScoreArea::Scene::dragEnterEvent(QGraphicsSceneDragDropEvent *event)
 {
     event->ignore();
@@ -40,23 +61,30 @@ void ScoreArea::Scene::dragEnterEvent(QGraphicsSceneDragDropEvent *event)
 ScoreArea::ScoreArea(QWidget *parent)
     : QGraphicsView(parent),
       myCaretPainter(nullptr),
-      myClickPubSub(std::make_shared<ClickPubSub>())
+      myClickPubSub(std::make_shared<ClickPubSub>()),
+      myIsHibernating(false)
 {
     setScene(&myScene);
+
+    // Tiles are finished on worker threads, so queue the repaint.
+    connect(&myTileCache, &TileCache::tileReady, this,
+            [=]() { viewport()->update(); }, Qt::QueuedConnection);
 }
 
 void ScoreArea::renderDocument(const Document &document)
 {
+    Util::Tracing::Span span("app", "Render score");
+    myIsHibernating = false;
     myScene.clear();
     myRenderedSystems.clear();
+    myTileCache.clear();
+    myDragStart.reset();
     myDocument = document;
 
     const Score &score = document.getScore();
+    mySpatialIndex.reset(static_cast<int>(score.getSystems().size()));
 
-    auto start = std::chrono::high_resolution_clock::now();
-
-    myCaretPainter =
-        new CaretPainter(document.getCaret(), document.getViewOptions());
+    myCaretPainter = new CaretPainter(document.getCaret(), mySpatialIndex);
     myCaretPainter->subscribeToMovement([=]() {
         adjustScroll();
     });
@@ -84,7 +112,8 @@ void ScoreArea::renderDocument(const Document &document)
         {
             for (int i = left; i < right; ++i)
             {
-                SystemRenderer render(this, score, document.getViewOptions());
+                SystemRenderer render(myClickPubSub, score,
+                                      document.getViewOptions());
                 myRenderedSystems[i] = render(score.getSystems()[i], i);
             }
         }, left, right));
@@ -103,25 +132,29 @@ void ScoreArea::renderDocument(const Document &document)
         height += system->boundingRect().height() + SYSTEM_SPACING;
         ++i;
 
-        myCaretPainter->addSystemRect(system->sceneBoundingRect());
+        indexSystem(i - 1);
+        myTileCache.addSystem(recordSystem(system),
+                              system->sceneBoundingRect().size());
     }
 
     myScene.addItem(myCaretPainter);
 
-    auto end = std::chrono::high_resolution_clock::now();
-    qDebug() << "Score rendered in"
-             << std::chrono::duration_cast<std::chrono::milliseconds>(
-                    end - start).count() << "ms";
-    qDebug() << "Rendered " << myScene.items().size() << "items";
+    Util::Tracing::recordCounter("Rendered items", myScene.items().size());
 }
 
 void ScoreArea::redrawSystem(int index)
 {
+    // Everything will be redrawn when the view wakes up.
+    if (myIsHibernating)
+        return;
+
+    Util::Tracing::Span span("app", "Redraw system");
+
     // Delete and remove the system from the scene.
     delete myRenderedSystems.takeAt(index);
 
     const Score &score = myDocument->getScore();
-    SystemRenderer render(this, score, myDocument->getViewOptions());
+    SystemRenderer render(myClickPubSub, score, myDocument->getViewOptions());
     QGraphicsItem *newSystem = render(score.getSystems()[index], index);
 
     double height = 0;
@@ -133,10 +166,16 @@ void ScoreArea::redrawSystem(int index)
 
     newSystem->setPos(0, height);
     height += newSystem->boundingRect().height() + SYSTEM_SPACING;
-    myCaretPainter->setSystemRect(index, newSystem->sceneBoundingRect());
 
     myScene.addItem(newSystem);
     myRenderedSystems.insert(index, newSystem);
+    indexSystem(index);
+
+    // Don't include the caret in the recording.
+    myCaretPainter->hide();
+    myTileCache.setSystem(index, recordSystem(newSystem),
+                          newSystem->sceneBoundingRect().size());
+    myCaretPainter->show();
 
     // Shift the following systems.
     for (int i = index + 1; i < myRenderedSystems.size(); ++i)
@@ -144,7 +183,7 @@ void ScoreArea::redrawSystem(int index)
         QGraphicsItem *system = myRenderedSystems[i];
         system->setPos(0, height);
         height += system->boundingRect().height() + SYSTEM_SPACING;
-        myCaretPainter->setSystemRect(i, system->sceneBoundingRect());
+        mySpatialIndex.setSystemTop(i, system->sceneBoundingRect().top());
     }
 
     // The spacing may have changed, so update the caret's position and redraw
@@ -152,13 +191,45 @@ void ScoreArea::redrawSystem(int index)
     myCaretPainter->updatePosition();
 }
 
+void ScoreArea::redrawStaff(int systemIndex, int staffIndex)
+{
+    if (myIsHibernating)
+        return;
+
+    const Score &score = myDocument->getScore();
+    SystemRenderer render(myClickPubSub, score, myDocument->getViewOptions());
+    QGraphicsItem *system = myRenderedSystems.at(systemIndex);
+
+    if (!render.redrawStaff(system, score.getSystems()[systemIndex],
+                            systemIndex, staffIndex))
+    {
+        redrawSystem(systemIndex);
+        return;
+    }
+
+    // The staff's height is unchanged, but the positions of its strings may
+    // have moved.
+    indexSystem(systemIndex);
+
+    // Don't include the caret in the recording.
+    myCaretPainter->hide();
+    myTileCache.setSystem(systemIndex, recordSystem(system),
+                          system->sceneBoundingRect().size());
+    myCaretPainter->show();
+
+    myCaretPainter->updatePosition();
+}
+
 void ScoreArea::print(QPrinter &printer)
 {
     QPainter painter;
     painter.begin(&printer);
 
-    // Hide the caret when printing.
+    // Hide the caret when printing, and show the items that are normally
+    // drawn from the tile cache.
     myCaretPainter->hide();
+    for (QGraphicsItem *system : myRenderedSystems)
+        system->graphicsEffect()->setEnabled(false);
 
     QRectF target(0, 0, painter.device()->width(), painter.device()->height());
 
@@ -185,6 +256,8 @@ void ScoreArea::print(QPrinter &printer)
         target.moveTop(target.y() + systemHeight + SYSTEM_SPACING * ratio);
     }
 
+    for (QGraphicsItem *system : myRenderedSystems)
+        system->graphicsEffect()->setEnabled(true);
     myCaretPainter->show();
     painter.end();
 }
@@ -194,6 +267,36 @@ std::shared_ptr<ClickPubSub> ScoreArea::getClickPubSub() const
     return myClickPubSub;
 }
 
+void ScoreArea::hibernate()
+{
+    if (myIsHibernating || !myDocument)
+        return;
+
+    myHibernatedScroll = QPoint(horizontalScrollBar()->value(),
+                                verticalScrollBar()->value());
+
+    // Only the document is kept. The scene rectangle is left unchanged so
+    // that the scroll bars stay the same until the score is rendered again.
+    myScene.clear();
+    myRenderedSystems.clear();
+    myTileCache.clear();
+    mySpatialIndex.reset(0);
+    myCaretPainter = nullptr;
+    myDragStart.reset();
+
+    myIsHibernating = true;
+}
+
+bool ScoreArea::isHibernating() const
+{
+    return myIsHibernating;
+}
+
+qint64 ScoreArea::getHiddenTime() const
+{
+    return myHiddenTimer.isValid() ? myHiddenTimer.elapsed() : 0;
+}
+
 void ScoreArea::adjustScroll()
 {
     if (myDocument->getCaret().isInPlaybackMode())
@@ -206,15 +309,162 @@ void ScoreArea::adjustScroll()
         ensureVisible(myCaretPainter->sceneBoundingRect(), 0, 0);
 }
 
+QPicture ScoreArea::recordSystem(QGraphicsItem *system)
+{
+    const QRectF source = system->sceneBoundingRect();
+
+    // The items still handle clicks, hover events, and tooltips, but are
+    // painted from the tile cache instead.
+    if (!system->graphicsEffect())
+        system->setGraphicsEffect(new SuppressPaintingEffect());
+    system->graphicsEffect()->setEnabled(false);
+
+    QPicture picture;
+    QPainter painter(&picture);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setRenderHint(QPainter::TextAntialiasing);
+    myScene.render(&painter, QRectF(QPointF(0, 0), source.size()), source);
+    painter.end();
+
+    system->graphicsEffect()->setEnabled(true);
+
+    return picture;
+}
+
+void ScoreArea::drawBackground(QPainter *painter, const QRectF &rect)
+{
+    QGraphicsView::drawBackground(painter, rect);
+
+    const double scale = transform().m11();
+    for (int i = 0; i < myRenderedSystems.size(); ++i)
+    {
+        const QGraphicsItem *system = myRenderedSystems[i];
+        if (system->sceneBoundingRect().intersects(rect))
+            myTileCache.draw(*painter, i, system->scenePos(), rect, scale);
+    }
+}
+
+void ScoreArea::indexSystem(int index)
+{
+    const QGraphicsItem *system = myRenderedSystems.at(index);
+
+    std::vector<SpatialIndex::StaffEntry> staves;
+    const LayoutInfo *firstLayout = nullptr;
+    for (const QGraphicsItem *child : system->childItems())
+    {
+        auto staff = qgraphicsitem_cast<const StaffPainter *>(child);
+        if (!staff)
+            continue;
+
+        staves.emplace_back(staff->getLocation().getStaffIndex(),
+                            staff->pos().y(), staff->getLayout());
+        if (!firstLayout)
+            firstLayout = &staff->getLayout();
+    }
+
+    std::sort(staves.begin(), staves.end(),
+              [](const SpatialIndex::StaffEntry &a,
+                 const SpatialIndex::StaffEntry &b) {
+                  return a.myIndex < b.myIndex;
+              });
+
+    mySpatialIndex.setSystem(index, system->sceneBoundingRect(), staves,
+                             firstLayout);
+}
+
+void ScoreArea::mousePressEvent(QMouseEvent *event)
+{
+    // Give clickable items (barlines, clefs, etc) the first chance to handle
+    // the event.
+    QGraphicsView::mousePressEvent(event);
+    myDragStart.reset();
+
+    if (event->isAccepted() || event->button() != Qt::LeftButton ||
+        !myDocument)
+    {
+        return;
+    }
+
+    // Otherwise, make a selection if a string in one of the staves was
+    // clicked.
+    auto hit = mySpatialIndex.find(mapToScene(event->pos()));
+    if (!hit || hit->myString < 0)
+        return;
+
+    myDragStart = hit;
+    ScoreLocation location(myDocument->getScore(), hit->mySystem,
+                           hit->myStaff, hit->myPosition);
+    location.setSelectionStart(hit->myPosition);
+    location.setString(hit->myString);
+
+    myClickPubSub->publish(ClickType::Selection, location);
+    event->accept();
+}
+
+void ScoreArea::mouseMoveEvent(QMouseEvent *event)
+{
+    if (!myDragStart || !(event->buttons() & Qt::LeftButton))
+    {
+        QGraphicsView::mouseMoveEvent(event);
+        return;
+    }
+
+    // Extend the selection within the staff where the drag started.
+    const SpatialIndex::Hit &start = *myDragStart;
+    const QRectF &rect = mySpatialIndex.getSystemRect(start.mySystem);
+    const QPointF point = mapToScene(event->pos());
+
+    ScoreLocation location(myDocument->getScore(), start.mySystem,
+                           start.myStaff,
+                           mySpatialIndex.findPosition(
+                               start.mySystem, point.x() - rect.left()));
+    location.setSelectionStart(start.myPosition);
+    location.setString(start.myString);
+
+    myClickPubSub->publish(ClickType::Selection, location);
+    event->accept();
+}
+
+void ScoreArea::mouseReleaseEvent(QMouseEvent *event)
+{
+    myDragStart.reset();
+    QGraphicsView::mouseReleaseEvent(event);
+}
+
 void ScoreArea::focusInEvent(QFocusEvent *)
 {
-    myScene.update(myCaretPainter->sceneBoundingRect());
+    if (myCaretPainter)
+        myScene.update(myCaretPainter->sceneBoundingRect());
 }
 
 void ScoreArea::focusOutEvent(QFocusEvent *)
 {
     // Redraw the caret to indicate that the score has lost focus.
-    myScene.update(myCaretPainter->sceneBoundingRect());
+    if (myCaretPainter)
+        myScene.update(myCaretPainter->sceneBoundingRect());
+}
+
+void ScoreArea::showEvent(QShowEvent *event)
+{
+    myHiddenTimer.invalidate();
+
+    if (myIsHibernating && myDocument)
+    {
+        renderDocument(*myDocument);
+        horizontalScrollBar()->setValue(myHibernatedScroll.x());
+        verticalScrollBar()->setValue(myHibernatedScroll.y());
+    }
+
+    QGraphicsView::showEvent(event);
+}
+
+void ScoreArea::hideEvent(QHideEvent *event)
+{
+    // Ignore the window being minimized, etc.
+    if (!event->spontaneous())
+        myHiddenTimer.start();
+
+    QGraphicsView::hideEvent(event);
 }
 
 void ScoreArea::zoomTo(double percent)
@@ -21,12 +21,16 @@
 #include <boost/optional.hpp>
 #include <memory>
 #include <QGraphicsScene>
+#include <painters/spatialindex.h>
+#include <painters/tilecache.h>
+#include <QElapsedTimer>
 #include <QGraphicsView>
 #include <score/staff.h>
 
 class CaretPainter;
 class ClickPubSub;
 class Document;
+class QPicture;
 class QPrinter;
 
 /// The visual display of the score.
@@ -54,22 +58,62 @@ public:
     /// necessary.
     void redrawSystem(int index);
 
+    /// Redraws a single staff, or the entire system if the staff's layout
+    /// affects the rest of the system.
+    void redrawStaff(int systemIndex, int staffIndex);
+
     std::shared_ptr<ClickPubSub> getClickPubSub() const;
 
+    /// Releases the rendered systems and tile cache to save memory, e.g. for
+    /// a tab that has not been viewed for a while. The document is rendered
+    /// again, at the same scroll position, when the view is next shown.
+    void hibernate();
+    /// Returns whether the rendered scene has been released.
+    bool isHibernating() const;
+    /// Returns how long (in milliseconds) the view has been hidden, or 0 if it
+    /// is visible.
+    qint64 getHiddenTime() const;
+
 protected:
+    virtual void showEvent(QShowEvent *event) override;
+    virtual void hideEvent(QHideEvent *event) override;
     virtual void focusInEvent(QFocusEvent *event) override;
     virtual void focusOutEvent(QFocusEvent *event) override;
+    virtual void mousePressEvent(QMouseEvent *event) override;
+    virtual void mouseMoveEvent(QMouseEvent *event) override;
+    virtual void mouseReleaseEvent(QMouseEvent *event) override;
+    /// Draws the systems from the tile cache rather than painting their items.
+    virtual void drawBackground(QPainter *painter, const QRectF &rect) override;
 
 private:
     /// Adjusts the scroll location whenever the caret moves.
     void adjustScroll();
 
+    /// Updates the spatial index with the layout of a rendered system.
+    void indexSystem(int index);
+
+    /// Records the system's drawing commands for the tile cache, and then
+    /// stops the system's items from being painted so that they are only used
+    /// for events.
+    QPicture recordSystem(QGraphicsItem *system);
+
     Scene myScene;
     boost::optional<const Document &> myDocument;
     QList<QGraphicsItem *> myRenderedSystems;
     CaretPainter *myCaretPainter;
+    TileCache myTileCache;
+    /// Used to find the staff, position, and string under the mouse.
+    SpatialIndex mySpatialIndex;
+    /// The location where a drag-selection started.
+    boost::optional<SpatialIndex::Hit> myDragStart;
 
     std::shared_ptr<ClickPubSub> myClickPubSub;
+
+    bool myIsHibernating;
+    /// The scroll position to restore when waking from hibernation.
+    QPoint myHibernatedScroll;
+    /// Started when the view is hidden (e.g. when switching to another tab).
+    QElapsedTimer myHiddenTimer;
 };
 
 #endif
@@ -28,6 +28,11 @@ const Setting<std::string> PreviousDirectory(
 
 const Setting<QByteArray> WindowState("app/window_state", QByteArray());
 
+const Setting<bool> MixerVisible("app/mixer_visible", true);
+
+const Setting<bool> InstrumentPanelVisible("app/instrument_panel_visible",
+                                           true);
+
 const Setting<std::vector<std::string>> RecentFiles("app/recent_files", {});
 
 const Setting<bool> OpenFilesInNewWindow("app/open_files_in_new_window",
@@ -40,6 +45,19 @@ const Setting<int> DefaultInstrumentPreset(
     "app/default_instrument_preset", Midi::MIDI_PRESET_ACOUSTIC_GUITAR_STEEL);
 
 const Setting<Tuning> DefaultTuning("app/default_tuning", Tuning());
+
+const Setting<int> ReducedDetailZoom("app/reduced_detail_zoom", 60);
+
+const Setting<int> OverviewDetailZoom("app/overview_detail_zoom", 30);
+
+const Setting<int> UndoMemoryLimit("app/undo_memory_limit", 256);
+
+const Setting<int> TabHibernationDelay("app/tab_hibernation_delay", 10);
+
+const Setting<int> MaxRenderedBackgroundTabs(
+    "app/max_rendered_background_tabs", 8);
+
+const Setting<std::string> TraceFile("app/trace_file", "");
 }
 
 Tuning SettingValueConverter<Tuning>::from(const SettingsTree::SettingValue &v)
@@ -28,12 +28,32 @@ namespace Settings
 {
     extern const Setting<std::string> PreviousDirectory;
     extern const Setting<QByteArray> WindowState;
+    /// The dock widgets are only created when they are visible.
+    extern const Setting<bool> MixerVisible;
+    extern const Setting<bool> InstrumentPanelVisible;
     extern const Setting<std::vector<std::string>> RecentFiles;
     extern const Setting<bool> OpenFilesInNewWindow;
 
     extern const Setting<std::string> DefaultInstrumentName;
     extern const Setting<int> DefaultInstrumentPreset;
     extern const Setting<Tuning> DefaultTuning;
+
+    /// Zoom levels (as a percentage) below which less detail is drawn.
+    extern const Setting<int> ReducedDetailZoom;
+    extern const Setting<int> OverviewDetailZoom;
+
+    /// Approximate memory limit (in MB) for each document's undo history.
+    extern const Setting<int> UndoMemoryLimit;
+
+    /// Background tabs release their rendered scores after this many minutes
+    /// (or never, if zero).
+    extern const Setting<int> TabHibernationDelay;
+    /// Maximum number of background tabs that keep their rendered scores.
+    extern const Setting<int> MaxRenderedBackgroundTabs;
+
+    /// If not empty, a performance trace is written to this file when the
+    /// application exits.
+    extern const Setting<std::string> TraceFile;
 }
 
 template <>
@@ -23,6 +23,68 @@
 
 static const char *theSettingsFilename = "settings.json";
 
+SettingsManager::Snapshot::Snapshot(const SettingsManager &manager)
+    : myManager(&manager)
+{
+    // Register as a reader before loading the pointer, so that a writer which
+    // sees no readers cannot free the snapshot that is loaded here.
+    myManager->myActiveSnapshots.fetch_add(1);
+    mySettings = myManager->myCurrentSnapshot.load();
+}
+
+SettingsManager::Snapshot::Snapshot(Snapshot &&other)
+    : myManager(other.myManager), mySettings(other.mySettings)
+{
+    other.myManager = nullptr;
+    other.mySettings = nullptr;
+}
+
+SettingsManager::Snapshot &SettingsManager::Snapshot::operator=(
+    Snapshot &&other)
+{
+    if (this != &other)
+    {
+        release();
+        myManager = other.myManager;
+        mySettings = other.mySettings;
+        other.myManager = nullptr;
+        other.mySettings = nullptr;
+    }
+
+    return *this;
+}
+
+SettingsManager::Snapshot::~Snapshot()
+{
+    release();
+}
+
+void SettingsManager::Snapshot::release()
+{
+    if (myManager)
+        myManager->myActiveSnapshots.fetch_sub(1);
+}
+
+SettingsManager::SettingsManager()
+    : myCurrentSnapshot(nullptr), myActiveSnapshots(0), mySnapshotVersion(0)
+{
+    mySnapshots.emplace_back(new SettingsTree());
+    myCurrentSnapshot.store(mySnapshots.back().get());
+}
+
+void SettingsManager::publishSnapshot()
+{
+    mySnapshots.emplace_back(new SettingsTree(mySettings));
+    myCurrentSnapshot.store(mySnapshots.back().get());
+    mySnapshotVersion.fetch_add(1, std::memory_order_release);
+
+    // Readers that start after this point will load the new snapshot, so the
+    // old ones can be freed if there are no readers right now. Otherwise, they
+    // are kept until the next time the settings are published.
+    if (myActiveSnapshots.load() == 0)
+        mySnapshots.erase(mySnapshots.begin(), mySnapshots.end() - 1);
+}
+
 void SettingsManager::load(const boost::filesystem::path &dir)
 {
 #ifdef __APPLE__
@@ -19,15 +19,45 @@
 #define APP_SETTINGSMANAGER_H
 
 #include <boost/filesystem/path.hpp>
+#include <atomic>
 #include <boost/signals2/signal.hpp>
+#include <memory>
 #include <mutex>
 #include <util/settingstree.h>
+#include <vector>
 
 class SettingsManager
 {
 public:
     typedef boost::signals2::signal<void()> SettingsChangedSignal;
 
+    /// An immutable copy of the settings, which is shared between readers.
+    /// Old copies are not freed while any snapshot is held, so snapshots
+    /// should only be held while reading the settings.
+    class Snapshot
+    {
+    public:
+        Snapshot(const Snapshot &) = delete;
+        Snapshot &operator=(const Snapshot &) = delete;
+        Snapshot(Snapshot &&other);
+        Snapshot &operator=(Snapshot &&other);
+        ~Snapshot();
+
+        const SettingsTree *operator->() const { return mySettings; }
+        const SettingsTree &operator*() const { return *mySettings; }
+        explicit operator bool() const { return mySettings != nullptr; }
+
+    private:
+        explicit Snapshot(const SettingsManager &manager);
+
+        void release();
+
+        friend class SettingsManager;
+
+        const SettingsManager *myManager;
+        const SettingsTree *mySettings;
+    };
+
     /// Handle to ensure the settings aren't modified while being accessed by
     /// another thread (e.g. the MIDI thread).
     template <typename T>
@@ -66,31 +96,37 @@ public:
     {
     public:
         WriteHandle(SettingsManager &manager)
-            : Handle(manager.mySettings, manager.myMutex),
-              mySignal(manager.mySettingsChangedSignal)
+            : Handle(manager.mySettings, manager.myMutex), myManager(manager)
         {
         }
 
         ~WriteHandle()
         {
+            // Nothing to do if the handle was moved from.
+            if (!myLock.owns_lock())
+                return;
+
+            myManager.publishSnapshot();
+
             // Unlock before signalling to avoid deadlocks if callbacks read the
             // settings.
             myLock.unlock();
-            mySignal();
+            myManager.mySettingsChangedSignal();
         }
 
         // TODO - change to a defaulted move constructor when VS2013 is no
         // longer supported.
         WriteHandle(WriteHandle &&other)
-            : Handle<SettingsTree>(std::move(other)), mySignal(other.mySignal)
+            : Handle<SettingsTree>(std::move(other)),
+              myManager(other.myManager)
         {
         }
 
     private:
-        SettingsChangedSignal &mySignal;
+        SettingsManager &myManager;
     };
 
-    SettingsManager() = default;
+    SettingsManager();
     SettingsManager(const SettingsManager &) = delete;
     SettingsManager &operator=(const SettingsManager &) = delete;
 
@@ -100,6 +136,22 @@ public:
         return ReadHandle(mySettings, myMutex);
     }
 
+    /// Returns the most recently published copy of the settings. This is
+    /// lock-free, so it is safe to call from e.g. the MIDI thread. The
+    /// snapshot remains valid (and unchanged) for as long as it is held.
+    Snapshot getSnapshot() const
+    {
+        return Snapshot(*this);
+    }
+
+    /// Returns a counter that is incremented whenever a new snapshot is
+    /// published. This can be polled cheaply to check whether a snapshot is
+    /// out of date.
+    unsigned int getSnapshotVersion() const
+    {
+        return mySnapshotVersion.load(std::memory_order_acquire);
+    }
+
     /// Obtain write access to the settings.
     WriteHandle getWriteHandle()
     {
@@ -123,8 +175,19 @@ private:
     template <typename T>
     friend class Handle;
 
+    /// Publishes a copy of the current settings. The write lock must be held.
+    void publishSnapshot();
+
     SettingsTree mySettings;
     mutable std::mutex myMutex;
+    /// All snapshots that may still be in use, ending with the current one.
+    /// Only accessed while the write lock is held.
+    std::vector<std::unique_ptr<const SettingsTree>> mySnapshots;
+    /// Readers load the current snapshot with a plain atomic pointer. Old
+    /// snapshots are only freed when no reader holds a snapshot.
+    std::atomic<const SettingsTree *> myCurrentSnapshot;
+    mutable std::atomic<int> myActiveSnapshots;
+    std::atomic<unsigned int> mySnapshotVersion;
 
     SettingsChangedSignal mySettingsChangedSignal;
 };
@@ -0,0 +1,99 @@
+/*
+  * Copyright (C) 2016 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "startupprofiler.h"
+
+#include <chrono>
+#include <iomanip>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+namespace
+{
+typedef std::chrono::steady_clock Clock;
+
+struct ProfilerState
+{
+    ProfilerState() : myIsEnabled(false)
+    {
+    }
+
+    bool myIsEnabled;
+    Clock::time_point myStartTime;
+    Clock::time_point myLastTime;
+    std::vector<std::pair<std::string, Clock::duration>> myPhases;
+};
+
+ProfilerState &getState()
+{
+    static ProfilerState state;
+    return state;
+}
+
+double toMilliseconds(Clock::duration duration)
+{
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+}
+
+namespace StartupProfiler
+{
+void enable()
+{
+    ProfilerState &state = getState();
+    state.myIsEnabled = true;
+    state.myStartTime = state.myLastTime = Clock::now();
+    state.myPhases.clear();
+}
+
+bool isEnabled()
+{
+    return getState().myIsEnabled;
+}
+
+void markPhase(const std::string &name)
+{
+    ProfilerState &state = getState();
+    if (!state.myIsEnabled)
+        return;
+
+    const Clock::time_point now = Clock::now();
+    state.myPhases.emplace_back(name, now - state.myLastTime);
+    state.myLastTime = now;
+}
+
+void report(std::ostream &os)
+{
+    const ProfilerState &state = getState();
+    if (!state.myIsEnabled)
+        return;
+
+    os << "Startup phases:" << std::endl;
+    os << std::fixed << std::setprecision(1);
+    for (auto &&phase : state.myPhases)
+    {
+        os << "  " << std::left << std::setw(32) << phase.first << std::right
+           << std::setw(10) << toMilliseconds(phase.second) << " ms"
+           << std::endl;
+    }
+
+    os << "  " << std::left << std::setw(32) << "Total" << std::right
+       << std::setw(10) << toMilliseconds(state.myLastTime - state.myStartTime)
+       << " ms" << std::endl;
+}
+}
@@ -0,0 +1,41 @@
+/*
+  * Copyright (C) 2016 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef APP_STARTUPPROFILER_H
+#define APP_STARTUPPROFILER_H
+
+#include <iosfwd>
+#include <string>
+
+/// Records how long each phase of the application's startup takes. Nothing
+/// is recorded unless profiling was enabled, e.g. with --profile-startup.
+namespace StartupProfiler
+{
+    /// Enables profiling. Each phase is timed from the end of the previous
+    /// phase, and the first phase is timed from this call.
+    void enable();
+
+    bool isEnabled();
+
+    /// Records that a phase of startup has finished.
+    void markPhase(const std::string &name);
+
+    /// Writes the duration of each phase and the total startup time.
+    void report(std::ostream &os);
+}
+
+#endif
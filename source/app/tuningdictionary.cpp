@@ -17,33 +17,231 @@
 
 #include "tuningdictionary.h"
 
+#include <algorithm>
 #include <app/appinfo.h>
 #include <app/paths.h>
 #include <boost/filesystem/fstream.hpp>
 #include <boost/filesystem/operations.hpp>
 #include <score/serialization.h>
 #include <stdexcept>
+#include <util/tracing.h>
 
 static const char *theTuningDictFilename = "tunings.json";
+static const char *theCacheFilename = "tunings.cache";
 
-std::vector<Tuning> TuningDictionary::load()
+/// Identifies the cache file format. This should be changed whenever the
+/// format changes.
+static const char theCacheMagic[8] = { 'P', 'T', 'E', 'T', 'U', 'N', '0', '1' };
+
+/// Limit on the length of the strings in the cache, to reject corrupt files.
+static const uint32_t theMaxCacheStringLength = 1 << 16;
+
+// The cache is only read by the machine that wrote it, so the values are
+// written in the native byte order.
+template <typename T>
+static void writeValue(std::ostream &os, const T &value)
 {
+    os.write(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+template <typename T>
+static bool readValue(std::istream &is, T &value)
+{
+    return static_cast<bool>(
+        is.read(reinterpret_cast<char *>(&value), sizeof(value)));
+}
+
+static void writeString(std::ostream &os, const std::string &str)
+{
+    writeValue(os, static_cast<uint32_t>(str.size()));
+    os.write(str.data(), str.size());
+}
+
+static bool readString(std::istream &is, std::string &str)
+{
+    uint32_t size;
+    if (!readValue(is, size) || size > theMaxCacheStringLength)
+        return false;
+
+    str.resize(size);
+    return size == 0 || static_cast<bool>(is.read(&str[0], size));
+}
+
+TuningDictionary::TuningDictionary() : myIsLoaded(false)
+{
+}
+
+TuningDictionary::TuningMap TuningDictionary::load()
+{
+    Util::Tracing::Span span("app", "Load tuning dictionary");
+
     for (boost::filesystem::path dir : Paths::getDataDirs())
     {
         auto path = dir / theTuningDictFilename;
         if (!boost::filesystem::exists(path))
             continue;
 
-        boost::filesystem::ifstream file(path);
-
+        const SourceInfo source = getSourceInfo(path);
         std::vector<Tuning> tunings;
-        ScoreUtils::load(file, "tunings", tunings);
-        return tunings;
+
+        boost::filesystem::ifstream cacheFile(getCachePath(),
+                                              std::ios::binary);
+        if (!cacheFile || !loadCache(cacheFile, source, tunings))
+        {
+            tunings.clear();
+
+            boost::filesystem::ifstream file(path);
+            ScoreUtils::load(file, "tunings", tunings);
+            updateCache(source, tunings);
+        }
+
+        TuningMap map;
+        for (const Tuning &tuning : tunings)
+            insert(map, tuning);
+        return map;
     }
 
     throw std::runtime_error("Could not locate tuning dictionary.");
 }
 
+boost::filesystem::path TuningDictionary::getCachePath()
+{
+    return Paths::getCacheDir() / theCacheFilename;
+}
+
+void TuningDictionary::updateCache(const SourceInfo &source,
+                                   const std::vector<Tuning> &tunings)
+{
+    // The cache is only an optimization, so ignore any errors when writing it.
+    const boost::filesystem::path path = getCachePath();
+    boost::system::error_code error;
+    boost::filesystem::create_directories(path.parent_path(), error);
+
+    // Several instances (e.g. one started with --warm) may update the cache
+    // at the same time, so write to a temporary file and then rename it over
+    // the cache. Readers then see either the old or the new file.
+    const boost::filesystem::path tempPath = boost::filesystem::unique_path(
+        path.string() + ".%%%%-%%%%-%%%%.tmp");
+    {
+        boost::filesystem::ofstream os(tempPath, std::ios::binary);
+        if (!os)
+            return;
+
+        saveCache(os, source, tunings);
+        if (!os.flush())
+        {
+            os.close();
+            boost::filesystem::remove(tempPath, error);
+            return;
+        }
+    }
+
+    boost::filesystem::rename(tempPath, path, error);
+    if (error)
+        boost::filesystem::remove(tempPath, error);
+}
+
+TuningDictionary::SourceInfo TuningDictionary::getSourceInfo(
+    const boost::filesystem::path &path)
+{
+    SourceInfo info;
+    info.myPath = path.string();
+    info.mySize = boost::filesystem::file_size(path);
+    info.myModifiedTime =
+        static_cast<int64_t>(boost::filesystem::last_write_time(path));
+    return info;
+}
+
+void TuningDictionary::saveCache(std::ostream &os, const SourceInfo &source,
+                                 const std::vector<Tuning> &tunings)
+{
+    os.write(theCacheMagic, sizeof(theCacheMagic));
+    writeString(os, source.myPath);
+    writeValue(os, source.mySize);
+    writeValue(os, source.myModifiedTime);
+
+    writeValue(os, static_cast<uint32_t>(tunings.size()));
+    for (const Tuning &tuning : tunings)
+    {
+        writeString(os, tuning.getName());
+
+        const std::vector<uint8_t> notes = tuning.getNotes();
+        writeValue(os, static_cast<uint8_t>(notes.size()));
+        os.write(reinterpret_cast<const char *>(notes.data()), notes.size());
+
+        writeValue(os, tuning.getMusicNotationOffset());
+        writeValue(os, static_cast<uint8_t>(tuning.usesSharps()));
+        writeValue(os, static_cast<int8_t>(tuning.getCapo()));
+    }
+}
+
+bool TuningDictionary::loadCache(std::istream &is, const SourceInfo &source,
+                                 std::vector<Tuning> &tunings)
+{
+    char magic[sizeof(theCacheMagic)];
+    if (!is.read(magic, sizeof(magic)) ||
+        !std::equal(magic, magic + sizeof(magic), theCacheMagic))
+    {
+        return false;
+    }
+
+    SourceInfo cached;
+    if (!readString(is, cached.myPath) || !readValue(is, cached.mySize) ||
+        !readValue(is, cached.myModifiedTime))
+    {
+        return false;
+    }
+
+    if (cached.myPath != source.myPath || cached.mySize != source.mySize ||
+        cached.myModifiedTime != source.myModifiedTime)
+    {
+        return false;
+    }
+
+    uint32_t count;
+    if (!readValue(is, count))
+        return false;
+
+    std::vector<Tuning> result;
+    try
+    {
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            std::string name;
+            uint8_t numStrings;
+            if (!readString(is, name) || !readValue(is, numStrings))
+                return false;
+
+            std::vector<uint8_t> notes(numStrings);
+            int8_t offset;
+            uint8_t sharps;
+            int8_t capo;
+            if (!is.read(reinterpret_cast<char *>(notes.data()), numStrings) ||
+                !readValue(is, offset) || !readValue(is, sharps) ||
+                !readValue(is, capo))
+            {
+                return false;
+            }
+
+            Tuning tuning;
+            tuning.setName(name);
+            tuning.setNotes(notes);
+            tuning.setMusicNotationOffset(offset);
+            tuning.setSharps(sharps != 0);
+            tuning.setCapo(capo);
+            result.push_back(tuning);
+        }
+    }
+    catch (const std::out_of_range &)
+    {
+        // The setters reject invalid values.
+        return false;
+    }
+
+    tunings = std::move(result);
+    return true;
+}
+
 void TuningDictionary::save() const
 {
     auto dir = Paths::getUserDataDir();
@@ -55,54 +253,118 @@ void TuningDictionary::save() const
         throw std::runtime_error("Error opening file for writing.");
 
     ensureLoaded();
-    ScoreUtils::save(file, "tunings", myTunings);
+
+    std::vector<Tuning> tunings;
+    for (auto &bucket : myTunings)
+    {
+        tunings.insert(tunings.end(), bucket.second.begin(),
+                       bucket.second.end());
+    }
+
+    ScoreUtils::save(file, "tunings", tunings);
+    file.close();
+
+    // Update the cache so that the next load doesn't need to parse the file.
+    updateCache(getSourceInfo(path), tunings);
 }
 
 void TuningDictionary::loadInBackground()
 {
+    if (myIsLoaded || myFuture.valid())
+        return;
+
     myFuture = std::async(std::launch::async, &TuningDictionary::load);
 }
 
-void TuningDictionary::findTunings(int numStrings,
-                                   std::vector<Tuning *> &tunings)
+const std::vector<Tuning> &TuningDictionary::getTunings(int numStrings) const
 {
+    static const std::vector<Tuning> theEmptyList;
+
     ensureLoaded();
-    for (Tuning &tuning : myTunings)
-    {
-        if (tuning.getStringCount() == numStrings)
-            tunings.push_back(&tuning);
-    }
+    auto it = myTunings.find(numStrings);
+    return it != myTunings.end() ? it->second : theEmptyList;
 }
 
 void TuningDictionary::findTunings(int numStrings,
-                                   std::vector<const Tuning *> &tunings) const
+                                   std::vector<Tuning *> &tunings)
 {
     ensureLoaded();
-    for (const Tuning &tuning : myTunings)
-    {
-        if (tuning.getStringCount() == numStrings)
-            tunings.push_back(&tuning);
-    }
+    auto it = myTunings.find(numStrings);
+    if (it == myTunings.end())
+        return;
+
+    for (Tuning &tuning : it->second)
+        tunings.push_back(&tuning);
+}
+
+void TuningDictionary::insert(TuningMap &tunings, const Tuning &tuning)
+{
+    std::vector<Tuning> &bucket = tunings[tuning.getStringCount()];
+    if (std::find(bucket.begin(), bucket.end(), tuning) == bucket.end())
+        bucket.push_back(tuning);
 }
 
 void TuningDictionary::addTuning(const Tuning &tuning)
 {
     ensureLoaded();
-    myTunings.push_back(tuning);
+    insert(myTunings, tuning);
+}
+
+void TuningDictionary::replaceTuning(const Tuning &oldTuning,
+                                     const Tuning &newTuning)
+{
+    ensureLoaded();
+
+    // The old tuning may refer to an entry in the dictionary, so copy it.
+    const Tuning tuning = oldTuning;
+    if (tuning == newTuning)
+        return;
+
+    // Replace the tuning in place, unless it needs to move to another group or
+    // the new tuning is already in the dictionary.
+    auto bucket = myTunings.find(tuning.getStringCount());
+    if (bucket != myTunings.end() &&
+        tuning.getStringCount() == newTuning.getStringCount())
+    {
+        std::vector<Tuning> &tunings = bucket->second;
+        auto it = std::find(tunings.begin(), tunings.end(), tuning);
+        if (it != tunings.end() &&
+            std::find(tunings.begin(), tunings.end(), newTuning) ==
+                tunings.end())
+        {
+            *it = newTuning;
+            return;
+        }
+    }
+
+    removeTuning(tuning);
+    addTuning(newTuning);
 }
 
 void TuningDictionary::removeTuning(const Tuning &tuning)
 {
     ensureLoaded();
-    myTunings.erase(std::remove(myTunings.begin(), myTunings.end(), tuning));
+
+    auto bucket = myTunings.find(tuning.getStringCount());
+    if (bucket == myTunings.end())
+        return;
+
+    std::vector<Tuning> &tunings = bucket->second;
+    auto it = std::find(tunings.begin(), tunings.end(), tuning);
+    if (it != tunings.end())
+        tunings.erase(it);
+
+    if (tunings.empty())
+        myTunings.erase(bucket);
 }
 
 void TuningDictionary::ensureLoaded() const
 {
-    if (myFuture.valid())
-    {
-        // myTunings shouldn't be mutable in general.
-        auto me = const_cast<TuningDictionary *>(this);
-        me->myTunings = myFuture.get();
-    }
+    if (myIsLoaded)
+        return;
+
+    // myTunings shouldn't be mutable in general.
+    auto me = const_cast<TuningDictionary *>(this);
+    me->myTunings = myFuture.valid() ? myFuture.get() : load();
+    me->myIsLoaded = true;
 }
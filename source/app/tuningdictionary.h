@@ -18,38 +18,88 @@
 #ifndef APP_TUNINGDICTIONARY_H
 #define APP_TUNINGDICTIONARY_H
 
+#include <boost/filesystem/path.hpp>
+#include <cstdint>
 #include <future>
+#include <iosfwd>
+#include <map>
 #include <score/tuning.h>
 #include <vector>
 
 class TuningDictionary
 {
 public:
+    TuningDictionary();
+
     /// Saves the tuning dictionary to a file.
     void save() const;
 
-    /// Loads the tuning dictionary in a separate thread.
+    /// Loads the tuning dictionary in a separate thread. If this is not
+    /// called, the dictionary is loaded when it is first used.
     void loadInBackground();
 
+    /// Loads the tuning dictionary if it hasn't been loaded yet, or waits for
+    /// the background load to finish.
+    void ensureLoaded() const;
+
+    /// Returns all tunings with the specified number of strings, in the order
+    /// that they were added.
+    const std::vector<Tuning> &getTunings(int numStrings) const;
+
     /// Returns all tunings with the specified number of strings.
     void findTunings(int numStrings, std::vector<Tuning *> &tunings);
-    void findTunings(int numStrings,
-                     std::vector<const Tuning *> &tunings) const;
 
-    /// Adds a new tuning to the tuning dictionary.
+    /// Adds a new tuning to the tuning dictionary, unless an identical
+    /// tuning is already present.
     void addTuning(const Tuning &tuning);
 
+    /// Replaces a tuning, which may have a different number of strings.
+    void replaceTuning(const Tuning &oldTuning, const Tuning &newTuning);
+
     /// Removes the specified tuning from the dictionary.
     void removeTuning(const Tuning &tuning);
 
+    /// Information about the file that the tunings were loaded from, which
+    /// is used to check whether the cache is out of date.
+    struct SourceInfo
+    {
+        std::string myPath;
+        uint64_t mySize;
+        int64_t myModifiedTime;
+    };
+
+    /// Writes the tunings to the cache, in a compact binary format.
+    static void saveCache(std::ostream &os, const SourceInfo &source,
+                          const std::vector<Tuning> &tunings);
+
+    /// Reads the tunings from the cache. Returns false if the cache is invalid
+    /// or was created from a different version of the source file.
+    static bool loadCache(std::istream &is, const SourceInfo &source,
+                          std::vector<Tuning> &tunings);
+
 private:
-    /// Loads the tuning dictionary from a file.
-    static std::vector<Tuning> load();
+    /// The tunings, grouped by their number of strings.
+    typedef std::map<int, std::vector<Tuning>> TuningMap;
 
-    void ensureLoaded() const;
+    /// Loads the tuning dictionary from the cache, or from a file if the cache
+    /// is out of date.
+    static TuningMap load();
+
+    /// Returns the location of the cache file.
+    static boost::filesystem::path getCachePath();
+
+    static SourceInfo getSourceInfo(const boost::filesystem::path &path);
+
+    /// Writes the cache, ignoring any errors.
+    static void updateCache(const SourceInfo &source,
+                            const std::vector<Tuning> &tunings);
+
+    /// Adds the tuning to the dictionary, unless it is a duplicate.
+    static void insert(TuningMap &tunings, const Tuning &tuning);
 
-    mutable std::future<std::vector<Tuning>> myFuture;
-    std::vector<Tuning> myTunings;
+    mutable std::future<TuningMap> myFuture;
+    bool myIsLoaded;
+    TuningMap myTunings;
 };
 
 #endif
@@ -17,6 +17,6 @@
   
 #include "viewoptions.h"
 
-ViewOptions::ViewOptions()
+ViewOptions::ViewOptions() : myDetailLevel(DetailLevel::Full)
 {
 }
\ No newline at end of file
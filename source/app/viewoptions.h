@@ -25,14 +25,31 @@
 class ViewOptions
 {
 public:
+    /// Controls how much of the score is drawn. When zoomed far out, small
+    /// symbols are not legible and can be skipped.
+    enum class DetailLevel
+    {
+        /// Draw everything.
+        Full,
+        /// Skip text symbols such as chord names, legato marks, and the
+        /// symbols above and below the staves.
+        Reduced,
+        /// Only draw the staves, barlines, and a stroke for each position.
+        Overview
+    };
+
     ViewOptions();
 
     const boost::optional<int> &getFilter() const { return myFilter; }
     void setFilter(int filter) { myFilter = filter; }
     void clearFilter() { myFilter.reset(); }
 
+    DetailLevel getDetailLevel() const { return myDetailLevel; }
+    void setDetailLevel(DetailLevel level) { myDetailLevel = level; }
+
 private:
     boost::optional<int> myFilter;
+    DetailLevel myDetailLevel;
 };
 
 #endif
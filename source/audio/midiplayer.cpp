@@ -60,24 +60,23 @@ void MidiPlayer::run()
     } BOOST_SCOPE_EXIT_END
 #endif
 
-    boost::signals2::scoped_connection connection(
-        mySettingsManager.subscribeToChanges([&]() {
-            auto settings = mySettingsManager.getReadHandle();
-            myMetronomeEnabled = settings->get(Settings::MetronomeEnabled);
-        }));
-
     setIsPlaying(true);
 
     MidiFile::LoadOptions options;
     options.myEnableMetronome = true;
     options.myRecordPositionChanges = true;
 
-    // Load MIDI settings.
+    // Load MIDI settings. A snapshot is used so that the playback thread
+    // never has to wait while the settings are being modified. The snapshot
+    // is released before playback starts, since old snapshots can't be freed
+    // while any snapshot is held.
+    unsigned int settings_version = mySettingsManager.getSnapshotVersion();
+    bool metronome_enabled;
     int api;
     int port;
     {
-        auto settings = mySettingsManager.getReadHandle();
-        myMetronomeEnabled = settings->get(Settings::MetronomeEnabled);
+        SettingsManager::Snapshot settings = mySettingsManager.getSnapshot();
+        metronome_enabled = settings->get(Settings::MetronomeEnabled);
 
         api = settings->get(Settings::MidiApi);
         port = settings->get(Settings::MidiPort);
@@ -156,9 +155,18 @@ void MidiPlayer::run()
 
         usleep(duration_us * (100.0 / myPlaybackSpeed));
 
+        // Pick up any changes to the settings (e.g. toggling the metronome).
+        const unsigned int version = mySettingsManager.getSnapshotVersion();
+        if (version != settings_version)
+        {
+            settings_version = version;
+            metronome_enabled = mySettingsManager.getSnapshot()->get(
+                Settings::MetronomeEnabled);
+        }
+
         // Don't play metronome events if the metronome is disabled.
         if (event->isNoteOnOff() && event->getChannel() == METRONOME_CHANNEL &&
-            !myMetronomeEnabled)
+            !metronome_enabled)
         {
             continue;
         }
@@ -192,8 +200,7 @@ void MidiPlayer::performCountIn(MidiOutputDevice &device,
     uint8_t velocity;
     uint8_t preset;
     {
-        auto settings = mySettingsManager.getReadHandle();
-
+        SettingsManager::Snapshot settings = mySettingsManager.getSnapshot();
         if (!settings->get(Settings::CountInEnabled))
             return;
 
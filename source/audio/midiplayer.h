@@ -58,7 +58,6 @@ private:
     const Score &myScore;
     SystemLocation myStartLocation;
     std::atomic<bool> myIsPlaying;
-    std::atomic<bool> myMetronomeEnabled;
     /// The current playback speed (percent).
     std::atomic<int> myPlaybackSpeed;
 };
@@ -0,0 +1,153 @@
+/*
+  * Copyright (C) 2016 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <app/appinfo.h>
+#include <app/paths.h>
+#include <app/settingsmanager.h>
+#include <app/viewoptions.h>
+#include <boost/program_options.hpp>
+#include <formats/fileformatmanager.h>
+#include <iostream>
+#include <painters/pageexporter.h>
+#include <QApplication>
+#include <QDir>
+#include <QFileInfo>
+#include <QFontDatabase>
+#include <score/score.h>
+#include <string>
+
+/// Command-line tool for exporting scores to printable pages, without
+/// opening the editor.
+int main(int argc, char *argv[])
+{
+    // The renderer requires a QApplication, but there is no need for a
+    // display.
+    if (qgetenv("QT_QPA_PLATFORM").isEmpty())
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+    QCoreApplication::setOrganizationName(AppInfo::ORGANIZATION_NAME);
+    QCoreApplication::setApplicationName(AppInfo::APPLICATION_ID);
+    QCoreApplication::setApplicationVersion(AppInfo::APPLICATION_VERSION);
+
+    PageExporter::Options options;
+    std::string format;
+    std::string outputDir;
+    std::vector<std::string> files;
+
+    namespace po = boost::program_options;
+    po::options_description desc("Usage: pte_export [options] files..."
+                                 "\nExports scores to PDF, PNG or SVG pages."
+                                 "\n\nOptions");
+    try
+    {
+        desc.add_options()
+            ("help,h", "Displays this help.")
+            ("format,f", po::value<std::string>(&format)->default_value("pdf"),
+             "Output format (pdf, png, or svg).")
+            ("output-dir,o", po::value<std::string>(&outputDir),
+             "Directory to write the pages to. Defaults to the directory of "
+             "each input file.")
+            ("dpi", po::value<int>(&options.myResolution)
+                        ->default_value(options.myResolution),
+             "Resolution for raster output.")
+            ("jobs,j", po::value<int>(&options.myMaxPagesInFlight)
+                           ->default_value(0),
+             "Number of pages to render concurrently (0 uses all cores).")
+            ("files", po::value<std::vector<std::string>>(&files),
+             "The files to be exported.");
+        po::positional_options_description p;
+        p.add("files", -1);
+        po::variables_map vm;
+        po::store(po::command_line_parser(argc, argv)
+                      .options(desc)
+                      .positional(p)
+                      .run(),
+                  vm);
+        po::notify(vm);
+
+        if (vm.count("help") || files.empty())
+        {
+            std::cout << desc << std::endl;
+            return vm.count("help") ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+
+        if (format == "pdf")
+            options.myFormat = PageExporter::Format::Pdf;
+        else if (format == "png")
+            options.myFormat = PageExporter::Format::Png;
+        else if (format == "svg")
+            options.myFormat = PageExporter::Format::Svg;
+        else
+            throw po::invalid_option_value(format);
+
+        if (options.myMaxPagesInFlight < 0)
+        {
+            throw po::invalid_option_value(
+                std::to_string(options.myMaxPagesInFlight));
+        }
+    }
+    catch (po::error &e)
+    {
+        std::cerr << "Error: " << e.what() << std::endl << std::endl;
+        std::cerr << desc << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Load the fonts that are used by the renderer.
+    QFontDatabase::addApplicationFont(":fonts/emmentaler-13.otf");
+    QFontDatabase::addApplicationFont(":fonts/LiberationSans-Regular.ttf");
+
+    SettingsManager settingsManager;
+    settingsManager.load(Paths::getConfigDir());
+    FileFormatManager formatManager(settingsManager);
+
+    int numErrors = 0;
+    for (const std::string &file : files)
+    {
+        const QFileInfo info(QString::fromStdString(file));
+        const QDir dir(outputDir.empty() ? info.path()
+                                         : QString::fromStdString(outputDir));
+        const QString path = dir.filePath(
+            info.completeBaseName() + "." + QString::fromStdString(format));
+
+        try
+        {
+            boost::optional<FileFormat> fileFormat =
+                formatManager.findFormat(info.suffix().toStdString());
+            if (!fileFormat)
+                throw std::runtime_error("Unsupported file type.");
+
+            Score score;
+            formatManager.importFile(score, file, *fileFormat);
+
+            ViewOptions viewOptions;
+            PageExporter exporter(score, viewOptions, options);
+            const int numPages = exporter.exportTo(path);
+
+            std::cout << file << ": exported " << numPages << " page(s)"
+                      << std::endl;
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << file << ": " << e.what() << std::endl;
+            ++numErrors;
+        }
+    }
+
+    return numErrors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
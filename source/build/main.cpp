@@ -20,16 +20,23 @@
 #include <app/powertabeditor.h>
 #include <app/settings.h>
 #include <app/settingsmanager.h>
+#include <app/startupprofiler.h>
+#include <boost/filesystem/fstream.hpp>
 #include <boost/program_options.hpp>
 #include <csignal>
 #include <dialogs/crashdialog.h>
 #include <exception>
+#include <functional>
 #include <iostream>
+#include <memory>
 #include <QApplication>
+#include <QFileInfo>
 #include <QFileOpenEvent>
 #include <QLocalServer>
 #include <QLocalSocket>
+#include <QTimer>
 #include <string>
+#include <util/tracing.h>
 #include <withershins.hpp>
 
 #ifdef _WIN32
@@ -108,6 +115,82 @@ static void signalHandler(int /*signal*/)
     displayError("Segmentation fault");
 }
 
+/// The server for the running instance.
+static QString getServerName()
+{
+    return QCoreApplication::applicationFilePath();
+}
+
+/// The server for an instance that was started with --warm and is waiting in
+/// the background.
+static QString getWarmServerName()
+{
+    return QCoreApplication::applicationFilePath() + ".warm";
+}
+
+/// Sends a list of files (possibly empty) to another instance, one per line
+/// and followed by a blank line. The paths are made absolute, since the other
+/// instance may have a different working directory. Returns false if there
+/// is no instance listening on the server.
+static bool sendFiles(const QString &serverName, const QStringList &files)
+{
+    QLocalSocket socket;
+    socket.connectToServer(serverName, QIODevice::WriteOnly);
+    if (!socket.waitForConnected(500))
+        return false;
+
+    QTextStream out(&socket);
+    out.setCodec("UTF-8");
+    for (const QString &file : files)
+        out << QFileInfo(file).absoluteFilePath() << "\n";
+    out << "\n";
+    out.flush();
+
+    socket.waitForBytesWritten();
+    socket.disconnectFromServer();
+    if (socket.state() != QLocalSocket::UnconnectedState)
+        socket.waitForDisconnected();
+
+    return true;
+}
+
+/// Collects the list of files from a client without blocking the event loop,
+/// and passes them to the callback once the client disconnects. Clients that
+/// disconnect without sending a complete message are ignored.
+static void receiveFiles(
+    QLocalSocket *socket,
+    const std::function<void(const QStringList &)> &callback)
+{
+    auto buffer = std::make_shared<QByteArray>();
+
+    auto finish = [=]() {
+        buffer->append(socket->readAll());
+        socket->deleteLater();
+
+        if (*buffer != "\n" && !buffer->endsWith("\n\n"))
+            return;
+
+        QStringList files;
+        for (const QString &file : QString::fromUtf8(*buffer).split('\n'))
+        {
+            if (!file.isEmpty())
+                files.push_back(file);
+        }
+
+        callback(files);
+    };
+
+    if (socket->state() == QLocalSocket::UnconnectedState)
+    {
+        finish();
+        return;
+    }
+
+    QObject::connect(socket, &QLocalSocket::readyRead,
+                     [=]() { buffer->append(socket->readAll()); });
+    QObject::connect(socket, &QLocalSocket::disconnected, finish);
+}
+
 class Application : public QApplication
 {
 public:
@@ -158,6 +241,8 @@ int main(int argc, char *argv[])
 #endif
 
     QStringList filesToOpen;
+    std::string traceFile;
+    bool warm = false;
 
     namespace po = boost::program_options;
     po::options_description desc("Usage: powertabeditor [options] [files...] "
@@ -167,6 +252,14 @@ int main(int argc, char *argv[])
         desc.add_options()
             ("help,h", "Displays this help.")
             ("version,v", "Displays version information.")
+            ("profile-startup",
+             "Prints the time taken by each phase of startup.")
+            ("trace", po::value<std::string>(),
+             "Writes a performance trace (in the Chrome trace format) to the "
+             "given file when the program exits.")
+            ("warm",
+             "Starts in the background without showing a window, so that "
+             "the next time the program is launched, files open quickly.")
             ("files", po::value<std::vector<std::string>>(),
              "The files to be opened, optionally.");
         po::positional_options_description p;
@@ -194,6 +287,17 @@ int main(int argc, char *argv[])
             return EXIT_SUCCESS;
         }
 
+        if (vm.count("profile-startup"))
+        {
+            StartupProfiler::enable();
+            StartupProfiler::markPhase("Initialize application");
+        }
+
+        if (vm.count("trace"))
+            traceFile = vm["trace"].as<std::string>();
+
+        warm = vm.count("warm") != 0;
+
         if (vm.count("files"))
         {
             auto files = vm["files"].as<std::vector<std::string>>();
@@ -215,53 +319,101 @@ int main(int argc, char *argv[])
         auto settings = settings_manager.getReadHandle();
         bool single_window_mode = !settings->get(Settings::OpenFilesInNewWindow);
 
-        // If an instance of the program is already running and we're in
-        // single-window mode, tell the running instance to open the files in
-        // new tabs.
-        if (!filesToOpen.empty() && single_window_mode)
+        if (traceFile.empty())
+            traceFile = settings->get(Settings::TraceFile);
+
+        if (warm)
         {
+            // Only one instance needs to wait in the background. Connecting
+            // without sending anything doesn't wake up the other instance.
             QLocalSocket socket;
-            socket.connectToServer(QCoreApplication::applicationFilePath(),
-                                   QIODevice::WriteOnly);
+            socket.connectToServer(getWarmServerName());
             if (socket.waitForConnected(500))
+                return EXIT_SUCCESS;
+        }
+        else
+        {
+            // If an instance of the program is already running and we're in
+            // single-window mode, tell the running instance to open the files
+            // in new tabs.
+            if (!filesToOpen.empty() && single_window_mode &&
+                sendFiles(getServerName(), filesToOpen))
             {
-                QTextStream out(&socket);
-                for (const QString &file : filesToOpen)
-                    out << file << "\n";
-                socket.waitForBytesWritten();
                 return EXIT_SUCCESS;
             }
+
+            // Otherwise, wake up an instance that is waiting in the
+            // background.
+            if (sendFiles(getWarmServerName(), filesToOpen))
+                return EXIT_SUCCESS;
         }
     }
 
+    StartupProfiler::markPhase("Check for running instance");
+
+    if (!traceFile.empty())
+        Util::Tracing::enable();
+
     // Otherwise, launch a new window.
     PowerTabEditor program;
 
     // Set up a server to listen for messages about new files being opened.
+    // The files are imported in the background, and opened once they are
+    // ready.
     QLocalServer server;
     QObject::connect(&server, &QLocalServer::newConnection, [&]() {
         QLocalSocket *socket = server.nextPendingConnection();
-        if (!socket->canReadLine())
-            socket->waitForReadyRead();
+        receiveFiles(socket, [&](const QStringList &files) {
+            if (warm)
+            {
+                // Take over as the running instance.
+                warm = false;
+                server.close();
+                server.listen(getServerName());
+                program.show();
+            }
+            else
+                program.showNormal();
 
-        QTextStream in(socket);
-        QStringList files;
+            program.activateWindow();
+            program.openFilesInBackground(files);
+        });
+    });
 
-        while (!in.atEnd())
-            files.push_back(in.readLine());
+    if (warm)
+    {
+        // Wait in the background until another instance hands off to us.
+        program.warmUp();
+        server.listen(getWarmServerName());
+    }
+    else
+    {
+        server.listen(getServerName());
 
-        program.openFiles(files);
-        program.showNormal();
-        program.activateWindow();
+        // Launch the application.
+        program.show();
+        StartupProfiler::markPhase("Show window");
+        program.openFiles(filesToOpen);
+        StartupProfiler::markPhase("Open files");
+    }
 
-        delete socket;
-    });
+    // Report the startup time once the event loop has processed the first
+    // frame and any deferred initialization.
+    if (StartupProfiler::isEnabled())
+    {
+        QTimer::singleShot(0, []() {
+            StartupProfiler::markPhase("First event loop iteration");
+            StartupProfiler::report(std::cerr);
+        });
+    }
 
-    server.listen(QCoreApplication::applicationFilePath());
+    const int result = a.exec();
 
-    // Launch the application.
-    program.show();
-    program.openFiles(filesToOpen);
+    if (!traceFile.empty())
+    {
+        boost::filesystem::ofstream os(traceFile);
+        Util::Tracing::save(os);
+    }
 
-    return a.exec();
+    return result;
 }
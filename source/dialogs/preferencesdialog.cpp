@@ -121,6 +121,8 @@ void PreferencesDialog::loadCurrentSettings()
 
     ui->openInNewWindowCheckBox->setChecked(
         settings->get(Settings::OpenFilesInNewWindow));
+    ui->traceFileLineEdit->setText(
+        QString::fromStdString(settings->get(Settings::TraceFile)));
 
     ui->defaultInstrumentNameLineEdit->setText(
         QString::fromStdString(settings->get(Settings::DefaultInstrumentName)));
@@ -173,6 +175,9 @@ void PreferencesDialog::accept()
     settings->set(Settings::OpenFilesInNewWindow,
                   ui->openInNewWindowCheckBox->isChecked());
 
+    settings->set(Settings::TraceFile,
+                  ui->traceFileLineEdit->text().toStdString());
+
     settings->set(Settings::DefaultInstrumentName,
                   ui->defaultInstrumentNameLineEdit->text().toStdString());
 
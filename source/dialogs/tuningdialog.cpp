@@ -146,17 +146,14 @@ void TuningDialog::updateEnabledStrings(int numStrings)
 
 void TuningDialog::updateTuningDictionary(int numStrings)
 {
-    std::vector<const Tuning *> tunings;
-    myDictionary.findTunings(numStrings, tunings);
-
     ui->presetComboBox->clear();
 
-    for (const Tuning *tuning : tunings)
+    for (const Tuning &tuning : myDictionary.getTunings(numStrings))
     {
         ui->presetComboBox->addItem(QString("%1 - %2").arg(
-            QString::fromStdString(tuning->getName()),
-            QString::fromStdString(boost::lexical_cast<std::string>(*tuning))),
-                                    QVariant::fromValue(tuning));
+            QString::fromStdString(tuning.getName()),
+            QString::fromStdString(boost::lexical_cast<std::string>(tuning))),
+                                    QVariant::fromValue(&tuning));
     }
 }
 
@@ -113,7 +113,9 @@ void TuningDictionaryDialog::onEditTuning()
 
     if (dialog.exec() == QDialog::Accepted)
     {
-        *tuning = dialog.getTuning();
+        // The number of strings may have changed, so the dictionary needs to
+        // update its index.
+        myDictionary.replaceTuning(*tuning, dialog.getTuning());
         onTuningModified();
     }
 }
@@ -23,6 +23,8 @@
 #include <formats/powertab/powertabimporter.h>
 #include <formats/powertab/powertabexporter.h>
 #include <formats/powertab_old/powertaboldimporter.h>
+#include <score/score.h>
+#include <util/tracing.h>
 
 FileFormatManager::FileFormatManager(const SettingsManager &settings_manager)
 {
@@ -80,7 +82,12 @@ void FileFormatManager::importFile(Score &score, const std::string &filename,
     {
         if (importer->fileFormat() == format)
         {
+            Util::Tracing::Span span("formats", "Import");
             importer->load(filename, score);
+
+            // The importers build the score incrementally, so compact it
+            // before it is used by the renderer and MIDI generator.
+            score.shrinkToFit();
             return;
         }
     }
@@ -111,6 +118,7 @@ void FileFormatManager::exportFile(const Score &score,
     {
         if (exporter->fileFormat() == format)
         {
+            Util::Tracing::Span span("formats", "Export");
             exporter->save(filename, score);
             return;
         }
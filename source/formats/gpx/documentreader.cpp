@@ -295,7 +295,7 @@ void Gpx::DocumentReader::readMasterBars(Score &score)
         if (startPos > POSITIONS_PER_SYSTEM)
         {
             system.getBarlines().back().setPosition(startPos + 1);
-            score.insertSystem(system);
+            score.insertSystem(std::move(system));
             system = System();
 
             for (auto &player : score.getPlayers())
@@ -389,7 +389,7 @@ void Gpx::DocumentReader::readMasterBars(Score &score)
                     pos.setRest();
 
                 pos.setPosition(currentPos++);
-                staff.getVoices()[0].insertPosition(pos);
+                staff.getVoices()[0].insertPosition(std::move(pos));
             }
 
             nextPos = std::max(nextPos, currentPos);
@@ -406,7 +406,7 @@ void Gpx::DocumentReader::readMasterBars(Score &score)
     }
 
     system.getBarlines().back().setPosition(startPos + 1);
-    score.insertSystem(system);
+    score.insertSystem(std::move(system));
 }
 
 void Gpx::DocumentReader::readBarlineType(const xml_node &masterBar,
@@ -327,7 +327,7 @@ void GuitarProImporter::convertScore(const Gp::Document &doc, Score &score)
         if (startPos > POSITIONS_PER_SYSTEM)
         {
             system.getBarlines().back().setPosition(startPos + 1);
-            score.insertSystem(system);
+            score.insertSystem(std::move(system));
             system = System();
 
             // Add a staff for each player.
@@ -384,7 +384,7 @@ void GuitarProImporter::convertScore(const Gp::Document &doc, Score &score)
     if (lastBar.getBarType() != Barline::RepeatEnd)
         lastBar.setBarType(Barline::DoubleBarFine);
 
-    score.insertSystem(system);
+    score.insertSystem(std::move(system));
 }
 
 int GuitarProImporter::convertBeat(const Gp::Beat &beat, System &system,
@@ -422,7 +422,7 @@ int GuitarProImporter::convertBeat(const Gp::Beat &beat, System &system,
         if (!gracePos.getNotes().empty())
         {
             gracePos.setProperty(Position::Acciaccatura);
-            voice.insertPosition(gracePos);
+            voice.insertPosition(std::move(gracePos));
             ++position;
         }
     }
@@ -511,7 +511,7 @@ int GuitarProImporter::convertBeat(const Gp::Beat &beat, System &system,
     pos.setProperty(Position::PalmMuting, hasPalmMutedNote);
     pos.setProperty(Position::LetRing, hasLetRingNote);
 
-    voice.insertPosition(pos);
+    voice.insertPosition(std::move(pos));
     return position + 1;
 }
 
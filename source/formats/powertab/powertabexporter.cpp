@@ -23,6 +23,7 @@
 #include <fstream>
 #include <score/score.h>
 #include <score/serialization.h>
+#include <util/tracing.h>
 
 PowerTabExporter::PowerTabExporter()
     : FileFormatExporter(getPowerTabFileFormat())
@@ -38,5 +39,6 @@ void PowerTabExporter::save(const std::string &filename, const Score &score)
     out.push(file);
 
     std::ostream compressed_output(&out);
+    Util::Tracing::Span span("formats", "Serialize score");
     ScoreUtils::save(compressed_output, "score", score);
 }
@@ -23,6 +23,7 @@
 #include <fstream>
 #include <score/score.h>
 #include <score/serialization.h>
+#include <util/tracing.h>
 
 PowerTabImporter::PowerTabImporter()
     : FileFormatImporter(getPowerTabFileFormat())
@@ -39,5 +40,6 @@ void PowerTabImporter::load(const std::string &filename, Score &score)
     in.push(file);
 
     std::istream compressed_input(&in);
+    Util::Tracing::Span span("formats", "Deserialize score");
     ScoreUtils::load(compressed_input, "score", score);
 }
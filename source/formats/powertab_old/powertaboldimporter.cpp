@@ -155,7 +155,7 @@ void PowerTabOldImporter::convert(const PowerTabDocument::Score &oldScore,
     {
         System system;
         convert(oldScore, oldScore.GetSystem(i), system);
-        score.insertSystem(system);
+        score.insertSystem(std::move(system));
     }
 
     // Convert Guitar In's to player changes.
@@ -291,7 +291,7 @@ void PowerTabOldImporter::convert(const PowerTabDocument::Score &oldScore,
         Staff staff;
         int lastPosInStaff = convert(*oldSystem->GetStaff(i), dynamicsInStaff,
                                      staff);
-        system.insertStaff(staff);
+        system.insertStaff(std::move(staff));
         lastPosition = std::max(lastPosition, lastPosInStaff);
     }
 
@@ -588,8 +588,8 @@ int PowerTabOldImporter::convert(
         {
             Position position;
             convert(*oldStaff.GetPosition(voice, i), position);
-            staff.getVoices()[voice].insertPosition(position);
             lastPosition = std::max(position.getPosition(), lastPosition);
+            staff.getVoices()[voice].insertPosition(std::move(position));
         }
     }
 
@@ -881,6 +881,8 @@ void PowerTabOldImporter::convertGuitarIns(
         score.getSystems()[i].insertPlayerChange(
             getPlayerChange(activePlayers, static_cast<int>(currentPosition)));
     }
+
+    score.invalidatePlayerChanges();
 }
 
 void PowerTabOldImporter::convertInitialVolumes(
@@ -18,8 +18,10 @@
 #include "midifile.h"
 
 #include "repeatcontroller.h"
+#include "timemap.h"
 
 #include <boost/rational.hpp>
+#include <iterator>
 
 #include <score/generalmidi.h>
 #include <score/score.h>
@@ -27,6 +29,7 @@
 #include <score/systemlocation.h>
 #include <score/utils.h>
 #include <score/voiceutils.h>
+#include <util/tracing.h>
 
 static const int PERCUSSION_CHANNEL = 9;
 static const int METRONOME_CHANNEL = PERCUSSION_CHANNEL;
@@ -114,6 +117,8 @@ MidiFile::MidiFile() : myTicksPerBeat(0)
 
 void MidiFile::load(const Score &score, const LoadOptions &options)
 {
+    Util::Tracing::Span span("midi", "MidiFile::load");
+
     myTicksPerBeat = DEFAULT_PPQ;
 
     RepeatController repeat_controller(score);
@@ -190,10 +195,12 @@ void MidiFile::load(const Score &score, const LoadOptions &options)
             system, location, next_bar->getPosition(), repeat_controller);
     }
 
-    myTracks.push_back(master_track);
-    myTracks.insert(myTracks.end(), regular_tracks.begin(), regular_tracks.end());
+    myTracks.push_back(std::move(master_track));
+    myTracks.insert(myTracks.end(),
+                    std::make_move_iterator(regular_tracks.begin()),
+                    std::make_move_iterator(regular_tracks.end()));
     if (options.myEnableMetronome)
-        myTracks.push_back(metronome_track);
+        myTracks.push_back(std::move(metronome_track));
 
     for (MidiEventList &track : myTracks)
     {
@@ -271,17 +278,7 @@ int MidiFile::addTempoEvent(MidiEventList &event_list, int current_tick,
     // If multiple tempo markers occur in a bar, just choose the last one.
     if (!markers.empty())
     {
-        const TempoMarker &marker = markers.back();
-
-        // Convert the values in the TempoMarker::BeatType enum to a factor that
-        // will scale the bpm value to be in terms of quarter notes.
-        boost::rational<int> scale(2, 1 << (marker.getBeatType() / 2));
-        if (marker.getBeatType() % 2 != 0)
-            scale *= boost::rational<int>(3, 2);
-
-        // Compute the number of microseconds per quarter note.
-        current_tempo = boost::rational_cast<int>(
-            60000000 / (scale * marker.getBeatsPerMinute()));
+        current_tempo = TimeMap::getBeatDuration(markers.back());
 
         event_list.append(MidiEvent::setTempo(current_tick, current_tempo));
     }
@@ -609,8 +606,8 @@ int MidiFile::addEventsForBar(
             continue;
 
         const SystemLocation system_location(system_index, position);
-        int duration = boost::rational_cast<int>(
-            myTicksPerBeat * VoiceUtils::getDurationTime(voice, *pos));
+        int duration = VoiceUtils::getFixedDurationTime(voice, *pos)
+                           .convertTicks(myTicksPerBeat);
 
         if (pos->isRest())
         {
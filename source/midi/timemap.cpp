@@ -0,0 +1,351 @@
+/*
+  * Copyright (C) 2016 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "timemap.h"
+
+#include "repeatcontroller.h"
+
+#include <algorithm>
+#include <boost/range/distance.hpp>
+#include <map>
+#include <score/generalmidi.h>
+#include <score/score.h>
+#include <score/utils.h>
+#include <score/voiceutils.h>
+
+/// Converts a duration in quarter notes to seconds.
+static double toSeconds(const FixedDuration &duration, int tempo)
+{
+    return duration.toDouble() * tempo / 1000000.0;
+}
+
+TimeMap::SystemInfo::SystemInfo() : myIsValid(false)
+{
+}
+
+TimeMap::TimeMap()
+{
+}
+
+void TimeMap::invalidateSystem(int index)
+{
+    std::lock_guard<std::mutex> lock(myMutex);
+
+    if (index >= 0 && index < static_cast<int>(mySystems.size()))
+        mySystems[index].myIsValid = false;
+}
+
+void TimeMap::invalidate()
+{
+    std::lock_guard<std::mutex> lock(myMutex);
+
+    for (SystemInfo &system : mySystems)
+        system.myIsValid = false;
+}
+
+int TimeMap::getBeatDuration(const TempoMarker &marker)
+{
+    // Convert the values in the TempoMarker::BeatType enum to a factor that
+    // will scale the bpm value to be in terms of quarter notes.
+    boost::rational<int> scale(2, 1 << (marker.getBeatType() / 2));
+    if (marker.getBeatType() % 2 != 0)
+        scale *= boost::rational<int>(3, 2);
+
+    // Compute the number of microseconds per quarter note.
+    return boost::rational_cast<int>(
+        60000000 / (scale * marker.getBeatsPerMinute()));
+}
+
+TimeMap::Bar TimeMap::measureBar(const Score &score, int systemIndex,
+                                 int barIndex)
+{
+    const System &system = score.getSystems()[systemIndex];
+    const Barline &barline = system.getBarlines()[barIndex];
+    const int start = barline.getPosition();
+    const int end = system.getBarlines()[barIndex + 1].getPosition();
+
+    Bar bar;
+    bar.myStart = start;
+
+    // If multiple tempo markers occur in a bar, the last one is used.
+    auto markers =
+        ScoreUtils::findInRange(system.getTempoMarkers(), start, end - 1);
+    if (!markers.empty())
+        bar.myTempo = getBeatDuration(markers.back());
+
+    const TimeSignature &timeSig = barline.getTimeSignature();
+    const Duration fullBar(boost::rational<int>(
+        4 * timeSig.getBeatsPerMeasure(), timeSig.getBeatValue()));
+    int multiBarCount = 1;
+
+    // Find the longest voice, and the earliest time at which each position is
+    // played in any voice.
+    std::map<int, Duration> offsets;
+    for (const Staff &staff : system.getStaves())
+    {
+        for (const Voice &voice : staff.getVoices())
+        {
+            Duration offset;
+            auto positions =
+                ScoreUtils::findInRange(voice.getPositions(), start, end - 1);
+
+            for (const Position &pos : positions)
+            {
+                auto it = offsets.find(pos.getPosition());
+                if (it == offsets.end())
+                    offsets.emplace(pos.getPosition(), offset);
+                else
+                    it->second = std::min(it->second, offset);
+
+                Duration duration =
+                    VoiceUtils::getFixedDurationTime(voice, pos);
+
+                // As in MidiFile, a whole rest that is alone in the bar lasts
+                // for the entire bar.
+                if (pos.isRest() &&
+                    pos.getDurationType() == Position::WholeNote &&
+                    boost::distance(positions) == 1)
+                {
+                    duration = fullBar;
+
+                    if (pos.hasMultiBarRest())
+                        duration = fullBar * pos.getMultiBarRestCount();
+                }
+
+                if (pos.hasMultiBarRest())
+                {
+                    multiBarCount =
+                        std::max(multiBarCount, pos.getMultiBarRestCount());
+                }
+
+                offset += duration;
+            }
+
+            bar.myLength = std::max(bar.myLength, offset);
+        }
+    }
+
+    // The metronome always plays the full bar.
+    bar.myLength = std::max(bar.myLength, fullBar * multiBarCount);
+    bar.myPositions.assign(offsets.begin(), offsets.end());
+
+    return bar;
+}
+
+/// Moves to the next bar, following any repeats or directions. This is the
+/// same as the traversal in MidiFile::load().
+static SystemLocation moveToNextBar(const System &system,
+                                    SystemLocation location, int nextBarPos,
+                                    RepeatController &repeatController)
+{
+    SystemLocation prevLocation = location;
+    SystemLocation newLocation;
+    for (int i = location.getPosition() + 1; i <= nextBarPos; ++i)
+    {
+        location.setPosition(i);
+
+        if (repeatController.checkForRepeat(prevLocation, location,
+                                            newLocation))
+        {
+            return newLocation;
+        }
+        else
+            prevLocation = location;
+    }
+
+    if (nextBarPos == system.getBarlines().back().getPosition())
+    {
+        location.setSystem(location.getSystem() + 1);
+        location.setPosition(0);
+    }
+    else
+        location.setPosition(nextBarPos);
+
+    return location;
+}
+
+void TimeMap::update(const Score &score)
+{
+    std::lock_guard<std::mutex> lock(myMutex);
+
+    const int numSystems = static_cast<int>(score.getSystems().size());
+    if (numSystems != static_cast<int>(mySystems.size()))
+    {
+        mySystems.clear();
+        mySystems.resize(numSystems);
+    }
+
+    // Measure the bars in any systems that have changed.
+    for (int i = 0; i < numSystems; ++i)
+    {
+        SystemInfo &info = mySystems[i];
+        if (info.myIsValid)
+            continue;
+
+        const System &system = score.getSystems()[i];
+        const int numBars = static_cast<int>(system.getBarlines().size()) - 1;
+
+        info.myBars.clear();
+        for (int bar = 0; bar < numBars; ++bar)
+            info.myBars.push_back(measureBar(score, i, bar));
+
+        info.myIsValid = true;
+    }
+
+    // Walk through the score in playback order.
+    mySegments.clear();
+    RepeatController repeatController(score);
+    SystemLocation location(0, 0);
+    double time = 0;
+    int tempo = Midi::BEAT_DURATION_120_BPM;
+
+    while (location.getSystem() < numSystems)
+    {
+        const System &system = score.getSystems()[location.getSystem()];
+        const Barline *nextBar = system.getNextBarline(location.getPosition());
+        const Bar *bar = findBar(location);
+
+        if (bar->myTempo)
+            tempo = *bar->myTempo;
+
+        Segment segment;
+        segment.myLocation = SystemLocation(location.getSystem(), bar->myStart);
+        segment.myBar = bar;
+        segment.myStartTime = time;
+        segment.myDuration = toSeconds(bar->myLength, tempo);
+        segment.myTempo = tempo;
+        mySegments.push_back(segment);
+
+        time += segment.myDuration;
+        location = moveToNextBar(system, location, nextBar->getPosition(),
+                                 repeatController);
+    }
+
+    // Index the first time that each bar is played.
+    myFirstSegments.clear();
+    for (size_t i = 0; i < mySegments.size(); ++i)
+        myFirstSegments.emplace_back(mySegments[i].myLocation, i);
+
+    std::stable_sort(myFirstSegments.begin(), myFirstSegments.end(),
+                     [](const std::pair<SystemLocation, size_t> &a,
+                        const std::pair<SystemLocation, size_t> &b) {
+                         return a.first < b.first;
+                     });
+    myFirstSegments.erase(
+        std::unique(myFirstSegments.begin(), myFirstSegments.end(),
+                    [](const std::pair<SystemLocation, size_t> &a,
+                       const std::pair<SystemLocation, size_t> &b) {
+                        return a.first == b.first;
+                    }),
+        myFirstSegments.end());
+}
+
+const TimeMap::Bar *TimeMap::findBar(const SystemLocation &location) const
+{
+    if (location.getSystem() < 0 ||
+        location.getSystem() >= static_cast<int>(mySystems.size()))
+    {
+        return nullptr;
+    }
+
+    // Find the last bar that starts at or before the position.
+    const std::vector<Bar> &bars = mySystems[location.getSystem()].myBars;
+    auto it = std::upper_bound(
+        bars.begin(), bars.end(), location.getPosition(),
+        [](int position, const Bar &bar) { return position < bar.myStart; });
+
+    if (it == bars.begin())
+        return nullptr;
+    else
+        return &*(--it);
+}
+
+boost::optional<double> TimeMap::getTime(const SystemLocation &location) const
+{
+    std::lock_guard<std::mutex> lock(myMutex);
+
+    const Bar *bar = findBar(location);
+    if (!bar)
+        return boost::none;
+
+    const SystemLocation barLocation(location.getSystem(), bar->myStart);
+    auto segment = std::lower_bound(
+        myFirstSegments.begin(), myFirstSegments.end(), barLocation,
+        [](const std::pair<SystemLocation, size_t> &entry,
+           const SystemLocation &loc) { return entry.first < loc; });
+
+    if (segment == myFirstSegments.end() || segment->first != barLocation)
+        return boost::none;
+
+    // Use the next position that is played, or the end of the bar if there
+    // are no more positions.
+    Duration offset = bar->myLength;
+    auto pos = std::lower_bound(
+        bar->myPositions.begin(), bar->myPositions.end(),
+        location.getPosition(),
+        [](const std::pair<int, Duration> &entry, int position) {
+            return entry.first < position;
+        });
+    if (pos != bar->myPositions.end())
+        offset = pos->second;
+
+    const Segment &info = mySegments[segment->second];
+    return info.myStartTime + toSeconds(offset, info.myTempo);
+}
+
+SystemLocation TimeMap::getLocation(double time) const
+{
+    std::lock_guard<std::mutex> lock(myMutex);
+
+    if (mySegments.empty())
+        return SystemLocation(0, 0);
+
+    // Find the last segment that starts at or before the time.
+    auto segment = std::upper_bound(
+        mySegments.begin(), mySegments.end(), time,
+        [](double t, const Segment &s) { return t < s.myStartTime; });
+    if (segment != mySegments.begin())
+        --segment;
+
+    // Find the last position in the bar that has started playing.
+    const double elapsed = std::max(time - segment->myStartTime, 0.0);
+    SystemLocation location = segment->myLocation;
+    for (const auto &pos : segment->myBar->myPositions)
+    {
+        const double offset = toSeconds(pos.second, segment->myTempo);
+
+        if (offset <= elapsed)
+            location.setPosition(pos.first);
+        else
+            break;
+    }
+
+    return location;
+}
+
+double TimeMap::getDuration() const
+{
+    std::lock_guard<std::mutex> lock(myMutex);
+
+    if (mySegments.empty())
+        return 0;
+    else
+    {
+        const Segment &last = mySegments.back();
+        return last.myStartTime + last.myDuration;
+    }
+}
@@ -0,0 +1,113 @@
+/*
+  * Copyright (C) 2016 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef MIDI_TIMEMAP_H
+#define MIDI_TIMEMAP_H
+
+#include <boost/optional/optional.hpp>
+#include <mutex>
+#include <score/fixedduration.h>
+#include <score/systemlocation.h>
+#include <utility>
+#include <vector>
+
+class Score;
+class TempoMarker;
+
+/// Maps locations in the score to the time at which they are played, and
+/// vice versa. Repeats and musical directions are followed in the same way as
+/// during playback.
+///
+/// The length of each bar is cached per system, so after an edit only the
+/// modified systems need to be measured again. update() reads the score, but
+/// the queries only use the cached data and can be called from any thread.
+class TimeMap
+{
+public:
+    TimeMap();
+
+    /// Marks a system as modified, so that it is measured again by the next
+    /// call to update().
+    void invalidateSystem(int index);
+    /// Marks every system as modified.
+    void invalidate();
+
+    /// Measures any modified systems and rebuilds the playback order. If
+    /// systems were added or removed, the entire score is measured again.
+    void update(const Score &score);
+
+    /// Returns the time (in seconds) at which the location is first played,
+    /// or nothing if the location is never played.
+    boost::optional<double> getTime(const SystemLocation &location) const;
+
+    /// Returns the location that is being played at the given time (in
+    /// seconds).
+    SystemLocation getLocation(double time) const;
+
+    /// Returns the total playback time of the score, in seconds.
+    double getDuration() const;
+
+    /// Returns the duration of a quarter note (in microseconds) for the tempo
+    /// marker.
+    static int getBeatDuration(const TempoMarker &marker);
+
+private:
+    typedef FixedDuration Duration;
+
+    /// The timing of a bar, in quarter notes.
+    struct Bar
+    {
+        int myStart;
+        Duration myLength;
+        /// The tempo set by the bar, if any.
+        boost::optional<int> myTempo;
+        /// The offset of each position from the start of the bar, sorted by
+        /// position.
+        std::vector<std::pair<int, Duration>> myPositions;
+    };
+
+    struct SystemInfo
+    {
+        SystemInfo();
+
+        bool myIsValid;
+        std::vector<Bar> myBars;
+    };
+
+    /// A bar, in the order that it is played.
+    struct Segment
+    {
+        SystemLocation myLocation;
+        const Bar *myBar;
+        double myStartTime;
+        double myDuration;
+        /// Duration of a quarter note, in microseconds.
+        int myTempo;
+    };
+
+    static Bar measureBar(const Score &score, int system, int barIndex);
+
+    const Bar *findBar(const SystemLocation &location) const;
+
+    mutable std::mutex myMutex;
+    std::vector<SystemInfo> mySystems;
+    std::vector<Segment> mySegments;
+    /// The first segment for each bar in the score, sorted by location.
+    std::vector<std::pair<SystemLocation, size_t>> myFirstSegments;
+};
+
+#endif
@@ -18,9 +18,9 @@
 #include "caretpainter.h"
 
 #include <app/caret.h>
-#include <app/viewoptions.h>
 #include <boost/lexical_cast.hpp>
 #include <painters/layoutinfo.h>
+#include <painters/spatialindex.h>
 #include <QDebug>
 #include <QGraphicsScene>
 #include <QGraphicsView>
@@ -32,9 +32,9 @@
 const double CaretPainter::PEN_WIDTH = 0.75;
 const double CaretPainter::CARET_NOTE_SPACING = 6;
 
-CaretPainter::CaretPainter(const Caret &caret, const ViewOptions &view_options)
+CaretPainter::CaretPainter(const Caret &caret, const SpatialIndex &index)
     : myCaret(caret),
-      myViewOptions(view_options),
+      myIndex(index),
       myCaretConnection(caret.subscribeToChanges([=]() {
           onLocationChanged();
       }))
@@ -130,19 +130,9 @@ QRectF CaretPainter::boundingRect() const
         return QRectF();
 }
 
-void CaretPainter::addSystemRect(const QRectF &rect)
-{
-    mySystemRects.push_back(rect);
-}
-
-void CaretPainter::setSystemRect(int index, const QRectF &rect)
-{
-    mySystemRects.at(index) = rect;
-}
-
 QRectF CaretPainter::getCurrentSystemRect() const
 {
-    return mySystemRects.at(myCaret.getLocation().getSystemIndex());
+    return myIndex.getSystemRect(myCaret.getLocation().getSystemIndex());
 }
 
 void CaretPainter::updatePosition()
@@ -171,29 +161,11 @@ void CaretPainter::onLocationChanged()
                                   location.getSystemIndex(), location.getStaff(),
                                   location.getStaffIndex()));
 
-    const ViewFilter *filter =
-        myViewOptions.getFilter()
-            ? &location.getScore().getViewFilters()[*myViewOptions.getFilter()]
-            : nullptr;
-
-    // Compute the offset due to the previous (visible) staves.
-    double offset = 0;
-    for (int i = 0; i < location.getStaffIndex(); ++i)
-    {
-        if (!filter ||
-            filter->accept(location.getScore(), location.getSystemIndex(), i))
-        {
-            offset += LayoutInfo(location.getScore(), system,
-                                 location.getSystemIndex(),
-                                 system.getStaves()[i], i).getStaffHeight();
-        }
-    }
-
     const QRectF oldRect = sceneBoundingRect();
-    setPos(0, mySystemRects.at(location.getSystemIndex()).top() + offset +
-           myLayout->getSystemSymbolSpacing() + myLayout->getStaffHeight() -
-           myLayout->getTabStaffBelowSpacing() - myLayout->STAFF_BORDER_SPACING -
-           myLayout->getTabStaffHeight());
+    setPos(0, myIndex.getStaffTop(location.getSystemIndex(),
+                                  location.getStaffIndex()) +
+           myLayout->getStaffHeight() - myLayout->getTabStaffBelowSpacing() -
+           myLayout->STAFF_BORDER_SPACING - myLayout->getTabStaffHeight());
     update(boundingRect());
     // Ensure that a redraw always occurs at the old location.
     scene()->update(oldRect);
@@ -24,20 +24,18 @@
 
 class Caret;
 struct LayoutInfo;
-class ViewOptions;
+class SpatialIndex;
 
 class CaretPainter : public QGraphicsItem
 {
 public:
-    CaretPainter(const Caret &caret, const ViewOptions &view_options);
+    CaretPainter(const Caret &caret, const SpatialIndex &index);
 
     virtual void paint(QPainter *painter, const QStyleOptionGraphicsItem *,
                        QWidget *) override;
 
     virtual QRectF boundingRect() const override;
 
-    void addSystemRect(const QRectF &rect);
-    void setSystemRect(int index, const QRectF &rect);
     QRectF getCurrentSystemRect() const;
 
     void updatePosition();
@@ -52,9 +50,9 @@ private:
     void onLocationChanged();
 
     const Caret &myCaret;
-    const ViewOptions &myViewOptions;
+    /// Provides the location of each system and staff.
+    const SpatialIndex &myIndex;
     std::unique_ptr<LayoutInfo> myLayout;
-    std::vector<QRectF> mySystemRects;
     boost::signals2::scoped_connection myCaretConnection;
     LocationChangedSlot onMyLocationChanged;
 
@@ -27,6 +27,7 @@
 #include <score/utils.h>
 #include <score/voiceutils.h>
 #include <set>
+#include <util/tracing.h>
 
 const double LayoutInfo::STAFF_WIDTH = 750;
 const int LayoutInfo::NUM_STD_NOTATION_LINES = 5;
@@ -55,6 +56,8 @@ LayoutInfo::LayoutInfo(const Score &score, const System &system, int systemIndex
       myStdNotationStaffAboveSpacing(0),
       myStdNotationStaffBelowSpacing(0)
 {
+    Util::Tracing::Span span("painters", "LayoutInfo");
+
     computePositionSpacing();
     calculateTabStaffBelowLayout();
     calculateTabStaffAboveLayout();
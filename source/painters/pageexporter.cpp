@@ -0,0 +1,321 @@
+/*
+  * Copyright (C) 2016 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "pageexporter.h"
+
+#include <algorithm>
+#include <app/pubsub/clickpubsub.h>
+#include <app/viewoptions.h>
+#include <deque>
+#include <future>
+#include <painters/layoutinfo.h>
+#include <painters/systemrenderer.h>
+#include <QDir>
+#include <QFileInfo>
+#include <QGraphicsItem>
+#include <QGraphicsScene>
+#include <QImage>
+#include <QPageSize>
+#include <QPainter>
+#include <QPdfWriter>
+#include <QSvgGenerator>
+#include <QThread>
+#include <score/score.h>
+#include <stdexcept>
+#include <thread>
+
+/// Matches the spacing between systems in the score area.
+static const double SYSTEM_SPACING = 50;
+static const double POINTS_PER_INCH = 72;
+
+struct PageExporter::RenderedPage
+{
+    std::unique_ptr<QGraphicsScene> myScene;
+    /// The location of each system in the scene.
+    std::vector<QRectF> mySources;
+};
+
+PageExporter::Options::Options()
+    : myFormat(Format::Pdf),
+      myPageSize(QPageSize(QPageSize::Letter).size(QPageSize::Point)),
+      myMargin(36),
+      myResolution(150),
+      myMaxPagesInFlight(0)
+{
+}
+
+PageExporter::PageExporter(const Score &score,
+                           const ViewOptions &view_options,
+                           const Options &options)
+    : myScore(score),
+      myViewOptions(view_options),
+      myOptions(options),
+      myPubSub(std::make_shared<ClickPubSub>())
+{
+}
+
+PageExporter::~PageExporter()
+{
+}
+
+double PageExporter::getSystemHeight(int systemIndex) const
+{
+    const System &system = myScore.getSystems()[systemIndex];
+    const boost::optional<int> filter = myViewOptions.getFilter();
+
+    // This must match the height of the system computed by SystemRenderer.
+    double height = 0;
+    int i = 0;
+    for (const Staff &staff : system.getStaves())
+    {
+        if (!filter || myScore.isStaffVisible(*filter, systemIndex, i))
+        {
+            const LayoutInfo layout(myScore, system, systemIndex, staff, i);
+            if (height == 0)
+                height += layout.getSystemSymbolSpacing();
+
+            height += layout.getStaffHeight();
+        }
+
+        ++i;
+    }
+
+    return height;
+}
+
+std::vector<PageExporter::Page> PageExporter::paginate() const
+{
+    const QRectF content =
+        QRectF(QPointF(0, 0), myOptions.myPageSize)
+            .adjusted(myOptions.myMargin, myOptions.myMargin,
+                      -myOptions.myMargin, -myOptions.myMargin);
+    const double widthRatio = content.width() / LayoutInfo::STAFF_WIDTH;
+
+    std::vector<Page> pages;
+    Page page;
+    double y = content.top();
+
+    const int numSystems = static_cast<int>(myScore.getSystems().size());
+    for (int i = 0; i < numSystems; ++i)
+    {
+        // Scale the system to fit the page width, unless it is too tall to
+        // fit on a single page.
+        const double height = getSystemHeight(i);
+        const double ratio =
+            (height > 0) ? std::min(widthRatio, content.height() / height)
+                         : widthRatio;
+        const double scaledHeight = height * ratio;
+
+        if (!page.mySystems.empty() && y + scaledHeight > content.bottom())
+        {
+            pages.push_back(page);
+            page = Page();
+            y = content.top();
+        }
+
+        page.mySystems.push_back(i);
+        page.myTargets.push_back(QRectF(content.left(), y,
+                                        LayoutInfo::STAFF_WIDTH * ratio,
+                                        scaledHeight));
+
+        y += scaledHeight + SYSTEM_SPACING * ratio;
+    }
+
+    if (!page.mySystems.empty())
+        pages.push_back(page);
+
+    return pages;
+}
+
+std::unique_ptr<PageExporter::RenderedPage> PageExporter::renderPage(
+    const Page &page) const
+{
+    std::unique_ptr<RenderedPage> rendered(new RenderedPage());
+    rendered->myScene.reset(new QGraphicsScene());
+
+    SystemRenderer render(myPubSub, myScore, myViewOptions);
+    double y = 0;
+
+    for (int index : page.mySystems)
+    {
+        QGraphicsItem *system = render(myScore.getSystems()[index], index);
+        system->setPos(0, y);
+        rendered->myScene->addItem(system);
+
+        const QRectF source = system->sceneBoundingRect();
+        rendered->mySources.push_back(source);
+        y = source.bottom() + SYSTEM_SPACING;
+    }
+
+    return rendered;
+}
+
+void PageExporter::paintPage(QPainter &painter, const Page &page,
+                             RenderedPage &rendered) const
+{
+    // Work in points, regardless of the device's resolution.
+    const double scale =
+        painter.device()->width() / myOptions.myPageSize.width();
+
+    painter.save();
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setRenderHint(QPainter::TextAntialiasing);
+
+    for (size_t i = 0; i < page.mySystems.size(); ++i)
+    {
+        const QRectF &target = page.myTargets[i];
+        rendered.myScene->render(
+            &painter, QRectF(target.topLeft() * scale, target.size() * scale),
+            rendered.mySources[i]);
+    }
+
+    painter.restore();
+}
+
+void PageExporter::writePage(const Page &page, RenderedPage &rendered,
+                             const QString &filename) const
+{
+    QPainter painter;
+
+    if (myOptions.myFormat == Format::Png)
+    {
+        const double scale = myOptions.myResolution / POINTS_PER_INCH;
+        QImage image((myOptions.myPageSize * scale).toSize(),
+                     QImage::Format_ARGB32_Premultiplied);
+        image.fill(Qt::white);
+
+        const int dotsPerMeter =
+            static_cast<int>(myOptions.myResolution / 0.0254 + 0.5);
+        image.setDotsPerMeterX(dotsPerMeter);
+        image.setDotsPerMeterY(dotsPerMeter);
+
+        painter.begin(&image);
+        paintPage(painter, page, rendered);
+        painter.end();
+
+        if (!image.save(filename))
+        {
+            throw std::runtime_error("Unable to write " +
+                                     filename.toStdString());
+        }
+    }
+    else
+    {
+        Q_ASSERT(myOptions.myFormat == Format::Svg);
+
+        QSvgGenerator generator;
+        generator.setFileName(filename);
+        generator.setResolution(POINTS_PER_INCH);
+        generator.setSize(myOptions.myPageSize.toSize());
+        generator.setViewBox(QRectF(QPointF(0, 0), myOptions.myPageSize));
+
+        if (!painter.begin(&generator))
+        {
+            throw std::runtime_error("Unable to write " +
+                                     filename.toStdString());
+        }
+
+        paintPage(painter, page, rendered);
+        painter.end();
+    }
+}
+
+int PageExporter::exportTo(const QString &path) const
+{
+    const std::vector<Page> pages = paginate();
+
+    size_t maxInFlight = std::max(myOptions.myMaxPagesInFlight, 0);
+    if (maxInFlight == 0)
+        maxInFlight = std::max(std::thread::hardware_concurrency(), 1u);
+
+    // All pages of a PDF go into a single file, so they must be written in
+    // order from this thread. The other formats can be written by the worker
+    // threads as soon as the page has been rendered.
+    const bool isPdf = (myOptions.myFormat == Format::Pdf);
+    std::unique_ptr<QPdfWriter> pdf;
+    QPainter pdfPainter;
+
+    if (isPdf)
+    {
+        pdf.reset(new QPdfWriter(path));
+        pdf->setPageSize(QPageSize(myOptions.myPageSize, QPageSize::Point));
+        pdf->setPageMargins(QMarginsF());
+        pdf->setResolution(myOptions.myResolution);
+
+        if (!pdfPainter.begin(pdf.get()))
+            throw std::runtime_error("Unable to write " + path.toStdString());
+    }
+
+    const QFileInfo info(path);
+    const QString baseName = QDir(info.path()).filePath(info.completeBaseName());
+    const QString extension =
+        (myOptions.myFormat == Format::Png) ? "png" : "svg";
+    QThread *outputThread = QThread::currentThread();
+
+    std::deque<std::future<std::unique_ptr<RenderedPage>>> tasks;
+    size_t nextPage = 0;
+    size_t pageNumber = 0;
+
+    while (pageNumber < pages.size())
+    {
+        // Keep a bounded number of pages in flight, so that memory usage does
+        // not depend on the length of the score.
+        while (nextPage < pages.size() && tasks.size() < maxInFlight)
+        {
+            const Page &page = pages[nextPage];
+            const QString filename = QString("%1-%2.%3")
+                                         .arg(baseName)
+                                         .arg(nextPage + 1)
+                                         .arg(extension);
+
+            tasks.push_back(std::async(std::launch::async, [=, &page]() {
+                std::unique_ptr<RenderedPage> rendered = renderPage(page);
+
+                if (isPdf)
+                    rendered->myScene->moveToThread(outputThread);
+                else
+                {
+                    writePage(page, *rendered, filename);
+                    rendered.reset();
+                }
+
+                return rendered;
+            }));
+
+            ++nextPage;
+        }
+
+        // Wait for the oldest page. This rethrows any errors from the worker.
+        std::unique_ptr<RenderedPage> rendered = tasks.front().get();
+        tasks.pop_front();
+
+        if (isPdf)
+        {
+            if (pageNumber > 0)
+                pdf->newPage();
+
+            paintPage(pdfPainter, pages[pageNumber], *rendered);
+        }
+
+        ++pageNumber;
+    }
+
+    if (isPdf)
+        pdfPainter.end();
+
+    return static_cast<int>(pages.size());
+}
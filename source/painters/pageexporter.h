@@ -0,0 +1,109 @@
+/*
+  * Copyright (C) 2016 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PAINTERS_PAGEEXPORTER_H
+#define PAINTERS_PAGEEXPORTER_H
+
+#include <memory>
+#include <QRectF>
+#include <QSizeF>
+#include <QString>
+#include <vector>
+
+class ClickPubSub;
+class QPainter;
+class Score;
+class ViewOptions;
+
+/// Renders a score to printable pages without needing a score area. Pages are
+/// laid out and drawn concurrently on worker threads, and are written to disk
+/// in order as soon as they are finished.
+class PageExporter
+{
+public:
+    enum class Format
+    {
+        Png,
+        Svg,
+        Pdf
+    };
+
+    struct Options
+    {
+        Options();
+
+        Format myFormat;
+        /// Size of each page, in points (1/72 inch).
+        QSizeF myPageSize;
+        /// Blank space around the edges of the page, in points.
+        double myMargin;
+        /// Resolution used for raster output.
+        int myResolution;
+        /// Maximum number of pages that are rendered or held in memory at
+        /// once. If zero (or negative), the number of hardware threads is
+        /// used.
+        int myMaxPagesInFlight;
+    };
+
+    /// The systems that appear on a page, along with where each system is
+    /// drawn (in points).
+    struct Page
+    {
+        std::vector<int> mySystems;
+        std::vector<QRectF> myTargets;
+    };
+
+    PageExporter(const Score &score, const ViewOptions &view_options,
+                 const Options &options);
+    ~PageExporter();
+
+    /// Splits the score's systems into pages.
+    std::vector<Page> paginate() const;
+
+    /// Exports the score. For PDF output, all pages are written to a single
+    /// file at the given path. Otherwise, one file is written per page, with
+    /// the page number appended to the file name (e.g. "song-1.png").
+    /// @return The number of pages that were written.
+    /// @throws std::exception If a page could not be written.
+    int exportTo(const QString &path) const;
+
+private:
+    struct RenderedPage;
+
+    /// Lays out the systems on a page.
+    std::unique_ptr<RenderedPage> renderPage(const Page &page) const;
+
+    /// Draws a page that was laid out by renderPage().
+    void paintPage(QPainter &painter, const Page &page,
+                   RenderedPage &rendered) const;
+
+    /// Writes a single page in a raster or SVG format.
+    void writePage(const Page &page, RenderedPage &rendered,
+                   const QString &filename) const;
+
+    /// Returns the height of the system, computed from its layout without
+    /// creating any graphics items.
+    double getSystemHeight(int systemIndex) const;
+
+    const Score &myScore;
+    const ViewOptions &myViewOptions;
+    const Options myOptions;
+    /// Unused, but the renderer expects a target for click events.
+    std::shared_ptr<ClickPubSub> myPubSub;
+};
+
+#endif
@@ -0,0 +1,139 @@
+/*
+  * Copyright (C) 2016 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "spatialindex.h"
+
+#include <algorithm>
+#include <cmath>
+#include <painters/layoutinfo.h>
+
+SpatialIndex::StaffEntry::StaffEntry(int index, double top,
+                                     const LayoutInfo &layout)
+    : myIndex(index),
+      myTop(top),
+      myHeight(layout.getStaffHeight()),
+      myTopTabLine(layout.getTopTabLine()),
+      myTabLineSpacing(layout.getTabLineSpacing()),
+      myStringCount(layout.getStringCount())
+{
+}
+
+void SpatialIndex::reset(int numSystems)
+{
+    mySystems.clear();
+    mySystems.resize(numSystems);
+}
+
+void SpatialIndex::setSystem(int index, const QRectF &rect,
+                             const std::vector<StaffEntry> &staves,
+                             const LayoutInfo *layout)
+{
+    SystemEntry &entry = mySystems.at(index);
+    entry.myRect = rect;
+    entry.myStaves = staves;
+    entry.myPositions.clear();
+
+    if (layout)
+    {
+        const int numPositions = layout->getNumPositions();
+        entry.myPositions.reserve(numPositions);
+        for (int i = 0; i < numPositions; ++i)
+            entry.myPositions.push_back(layout->getPositionX(i));
+    }
+}
+
+void SpatialIndex::setSystemTop(int index, double top)
+{
+    mySystems.at(index).myRect.moveTop(top);
+}
+
+const QRectF &SpatialIndex::getSystemRect(int index) const
+{
+    return mySystems.at(index).myRect;
+}
+
+double SpatialIndex::getStaffTop(int system, int staff) const
+{
+    const SystemEntry &entry = mySystems.at(system);
+
+    auto it = std::lower_bound(
+        entry.myStaves.begin(), entry.myStaves.end(), staff,
+        [](const StaffEntry &s, int index) { return s.myIndex < index; });
+
+    if (it == entry.myStaves.end())
+        return entry.myRect.bottom();
+    else
+        return entry.myRect.top() + it->myTop;
+}
+
+boost::optional<SpatialIndex::Hit> SpatialIndex::find(
+    const QPointF &point) const
+{
+    // Find the last system that starts above the point.
+    auto system = std::upper_bound(
+        mySystems.begin(), mySystems.end(), point.y(),
+        [](double y, const SystemEntry &s) { return y < s.myRect.top(); });
+    if (system == mySystems.begin())
+        return boost::none;
+
+    --system;
+    if (point.y() > system->myRect.bottom())
+        return boost::none;
+
+    // Find the staff within the system.
+    const double y = point.y() - system->myRect.top();
+    auto staff = std::upper_bound(
+        system->myStaves.begin(), system->myStaves.end(), y,
+        [](double y, const StaffEntry &s) { return y < s.myTop; });
+    if (staff == system->myStaves.begin())
+        return boost::none;
+
+    --staff;
+    if (y > staff->myTop + staff->myHeight)
+        return boost::none;
+
+    Hit hit;
+    hit.mySystem = static_cast<int>(system - mySystems.begin());
+    hit.myStaff = staff->myIndex;
+    hit.myPosition =
+        findPosition(hit.mySystem, point.x() - system->myRect.left());
+
+    // Find the position relative to the top of the staff, in terms of the tab
+    // line spacing. Then, round it to find the string index.
+    hit.myString = static_cast<int>(
+        std::floor((y - staff->myTop - staff->myTopTabLine) /
+                       staff->myTabLineSpacing +
+                   0.5));
+    if (hit.myString < 0 || hit.myString >= staff->myStringCount)
+        hit.myString = -1;
+
+    return hit;
+}
+
+int SpatialIndex::findPosition(int system, double x) const
+{
+    const std::vector<double> &positions = mySystems.at(system).myPositions;
+    if (positions.empty())
+        return 0;
+
+    // This matches LayoutInfo::getPositionFromX().
+    auto it = std::lower_bound(positions.begin(), positions.end(), x);
+    if (it == positions.begin())
+        return 0;
+    else
+        return static_cast<int>(it - positions.begin()) - 1;
+}
@@ -0,0 +1,98 @@
+/*
+  * Copyright (C) 2016 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PAINTERS_SPATIALINDEX_H
+#define PAINTERS_SPATIALINDEX_H
+
+#include <boost/optional/optional.hpp>
+#include <QPointF>
+#include <QRectF>
+#include <vector>
+
+struct LayoutInfo;
+
+/// Maps scene coordinates to locations in the score, without searching through
+/// the scene's items. The systems, the staves within a system, and the
+/// positions within a staff never overlap, so each level is stored as a sorted
+/// list of intervals and searched in O(log n).
+class SpatialIndex
+{
+public:
+    /// The layout of a visible staff, relative to the top of its system.
+    struct StaffEntry
+    {
+        StaffEntry(int index, double top, const LayoutInfo &layout);
+
+        int myIndex;
+        double myTop;
+        double myHeight;
+        double myTopTabLine;
+        double myTabLineSpacing;
+        int myStringCount;
+    };
+
+    /// A location in the score.
+    struct Hit
+    {
+        int mySystem;
+        int myStaff;
+        int myPosition;
+        /// The string that was clicked on, or -1 if the point is outside of
+        /// the tab staff.
+        int myString;
+    };
+
+    /// Discards all systems, and reserves space for the given number of
+    /// systems.
+    void reset(int numSystems);
+
+    /// Records the layout of a system. All staves in a system share the same
+    /// position spacing, so the x-coordinates are taken from the first staff.
+    void setSystem(int index, const QRectF &rect,
+                   const std::vector<StaffEntry> &staves,
+                   const LayoutInfo *layout);
+
+    /// Moves a system vertically, e.g. after a previous system changes height.
+    void setSystemTop(int index, double top);
+
+    /// Returns the bounding rectangle of the system.
+    const QRectF &getSystemRect(int index) const;
+
+    /// Returns the scene y-coordinate of the top of the given staff. If the
+    /// staff is hidden, the location of the next visible staff is used.
+    double getStaffTop(int system, int staff) const;
+
+    /// Finds the location at the given point, if it is within a staff.
+    boost::optional<Hit> find(const QPointF &point) const;
+
+    /// Finds the position in the system that is nearest to the given
+    /// x-coordinate.
+    int findPosition(int system, double x) const;
+
+private:
+    struct SystemEntry
+    {
+        QRectF myRect;
+        std::vector<StaffEntry> myStaves;
+        /// The x-coordinate of each position in the system.
+        std::vector<double> myPositions;
+    };
+
+    std::vector<SystemEntry> mySystems;
+};
+
+#endif
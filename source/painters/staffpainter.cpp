@@ -17,73 +17,41 @@
   
 #include "staffpainter.h"
 
-#include <app/pubsub/clickpubsub.h>
-#include <cmath>
-#include <QGraphicsSceneMouseEvent>
 #include <QPainter>
 
 StaffPainter::StaffPainter(const LayoutConstPtr &layout,
-                           const ScoreLocation &location,
-                           const std::shared_ptr<ClickPubSub> &pubsub)
+                           const ScoreLocation &location)
     : myLayout(layout),
-      myPubSub(pubsub),
       myLocation(location),
       myBounds(0, 0, LayoutInfo::STAFF_WIDTH, layout->getStaffHeight())
 {
-    // Only use the left mouse button for making selections.
-    setAcceptedMouseButtons(Qt::LeftButton);
-}
-
-void StaffPainter::mousePressEvent(QGraphicsSceneMouseEvent *event)
-{
-    const double x = event->pos().x();
-    const double y = event->pos().y();
+    // Clicks are handled by the score area, using its spatial index.
+    setAcceptedMouseButtons(Qt::NoButton);
 
-    // Find the position relative to the top of the staff, in terms of the tab
-    // line spacing. Then, round it to find the string index.
-    const int string = std::floor(((y - myLayout->getTopTabLine()) /
-                                   myLayout->getTabLineSpacing()) + 0.5);
+    // Standard notation staff.
+    addStaffLines(myStaffLines, LayoutInfo::NUM_STD_NOTATION_LINES,
+                  myLayout->STD_NOTATION_LINE_SPACING,
+                  myLayout->getTopStdNotationLine());
 
-    if (string >= 0 && string < myLayout->getStringCount())
-    {
-        const int position = myLayout->getPositionFromX(x);
-        myLocation.setPositionIndex(position);
-        myLocation.setSelectionStart(position);
-        myLocation.setString(string);
-
-        myPubSub->publish(ClickType::Selection, myLocation);
-    }
-}
-
-void StaffPainter::mouseMoveEvent(QGraphicsSceneMouseEvent *event)
-{
-    const double x = event->pos().x();
-    myLocation.setPositionIndex(myLayout->getPositionFromX(x));
-    myPubSub->publish(ClickType::Selection, myLocation);
+    // Tab staff.
+    addStaffLines(myStaffLines, myLayout->getStringCount(),
+                  myLayout->getTabLineSpacing(), myLayout->getTopTabLine());
 }
 
 void StaffPainter::paint(QPainter *painter, const QStyleOptionGraphicsItem *,
                          QWidget *)
 {
     painter->setPen(QPen(QBrush(QColor(213,213,213)), 0.75));
-
-    // Draw standard notation staff.
-    drawStaffLines(painter, LayoutInfo::NUM_STD_NOTATION_LINES,
-                   myLayout->STD_NOTATION_LINE_SPACING,
-                   myLayout->getTopStdNotationLine());
-
-    // Draw tab staff.
-    drawStaffLines(painter, myLayout->getStringCount(),
-                   myLayout->getTabLineSpacing(), myLayout->getTopTabLine());
+    painter->drawPath(myStaffLines);
 }
 
-void StaffPainter::drawStaffLines(QPainter *painter, int lineCount,
-                                  double lineSpacing, double startHeight)
+void StaffPainter::addStaffLines(QPainterPath &path, int lineCount,
+                                 double lineSpacing, double startHeight)
 {
     for (int i = 0; i < lineCount; i++)
     {
         const double height = i * lineSpacing + startHeight;
-        painter->drawLine(QPointF(0, height),
-                          QPointF(LayoutInfo::STAFF_WIDTH, height));
+        path.moveTo(0, height);
+        path.lineTo(LayoutInfo::STAFF_WIDTH, height);
     }
 }
@@ -21,17 +21,17 @@
 #include <memory>
 #include <painters/layoutinfo.h>
 #include <QGraphicsItem>
+#include <QPainterPath>
 #include <score/scorelocation.h>
 
-class ScoreLocation;
-class ClickPubSub;
 class Staff;
 
 class StaffPainter : public QGraphicsItem
 {
 public:
-    StaffPainter(const LayoutConstPtr &layout, const ScoreLocation &location,
-                 const std::shared_ptr<ClickPubSub> &pubsub);
+    enum { Type = UserType + 1 };
+
+    StaffPainter(const LayoutConstPtr &layout, const ScoreLocation &location);
 
     virtual void paint(QPainter *painter, const QStyleOptionGraphicsItem *,
                        QWidget *) override;
@@ -41,19 +41,22 @@ public:
         return myBounds;
     }
 
-protected:
-    virtual void mousePressEvent(QGraphicsSceneMouseEvent *event) override;
-    virtual void mouseMoveEvent(QGraphicsSceneMouseEvent *event) override;
+    /// Allows the item to be identified with qgraphicsitem_cast().
+    virtual int type() const override { return Type; }
+
+    const LayoutInfo &getLayout() const { return *myLayout; }
+    const ScoreLocation &getLocation() const { return myLocation; }
 
 private:
-    void drawStaffLines(QPainter *painter, int lineCount, double lineSpacing,
-                        double startHeight);
-    int getPositionFromX(double x) const;
+    /// Adds the lines of a staff to the path.
+    static void addStaffLines(QPainterPath &path, int lineCount,
+                              double lineSpacing, double startHeight);
 
     LayoutConstPtr myLayout;
-    std::shared_ptr<ClickPubSub> myPubSub;
     ScoreLocation myLocation;
     const QRectF myBounds;
+    /// All of the staff lines, so that they can be drawn in a single call.
+    QPainterPath myStaffLines;
 };
 
 #endif
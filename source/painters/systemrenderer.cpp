@@ -18,7 +18,6 @@
 #include "systemrenderer.h"
 
 #include <app/pubsub/clickpubsub.h>
-#include <app/scorearea.h>
 #include <app/viewoptions.h>
 #include <boost/algorithm/clamp.hpp>
 #include <boost/lexical_cast.hpp>
@@ -39,6 +38,7 @@
 #include <QGraphicsItem>
 #include <QPen>
 #include <score/score.h>
+#include <util/tracing.h>
 #include <score/scorelocation.h>
 #include <score/system.h>
 #include <score/utils.h>
@@ -58,9 +58,10 @@ void SystemRenderer::centerSymbolVertically(QGraphicsItem &item, double y)
                          item.boundingRect().height()));
 }
 
-SystemRenderer::SystemRenderer(const ScoreArea *score_area, const Score &score,
+SystemRenderer::SystemRenderer(const std::shared_ptr<ClickPubSub> &pubsub,
+                               const Score &score,
                                const ViewOptions &view_options)
-    : myScoreArea(score_area),
+    : myPubSub(pubsub),
       myScore(score),
       myViewOptions(view_options),
       myParentSystem(nullptr),
@@ -80,21 +81,20 @@ SystemRenderer::SystemRenderer(const ScoreArea *score_area, const Score &score,
 QGraphicsItem *SystemRenderer::operator()(const System &system,
                                           int systemIndex)
 {
+    Util::Tracing::Span span("painters", "SystemRenderer");
+
     // Draw the bounding rectangle for the system.
     myParentSystem = new QGraphicsRectItem();
     myParentSystem->setPen(QPen(QBrush(QColor(0, 0, 0, 127)), 0.5));
 
-    const ViewFilter *filter =
-        myViewOptions.getFilter()
-            ? &myScore.getViewFilters()[*myViewOptions.getFilter()]
-            : nullptr;
+    const boost::optional<int> filter = myViewOptions.getFilter();
 
     // Draw each staff.
     double height = 0;
     int i = 0;
     for (const Staff &staff : system.getStaves())
     {
-        if (filter && !filter->accept(myScore, systemIndex, i))
+        if (filter && !myScore.isStaffVisible(*filter, systemIndex, i))
         {
             ++i;
             continue;
@@ -106,42 +106,117 @@ QGraphicsItem *SystemRenderer::operator()(const System &system,
 
         if (isFirstStaff)
         {
-            drawSystemSymbols(system, *layout);
+            // The space for the system symbols is still reserved at lower
+            // detail levels, so that the layout does not change when zooming.
+            if (myViewOptions.getDetailLevel() == ViewOptions::DetailLevel::Full)
+                drawSystemSymbols(system, *layout);
             height += layout->getSystemSymbolSpacing();
         }
 
-        myParentStaff = new StaffPainter(layout,
-                                         ScoreLocation(myScore, systemIndex, i),
-                                         myScoreArea->getClickPubSub());
+        drawStaff(system, systemIndex, staff, i, layout, isFirstStaff);
         myParentStaff->setPos(0, height);
         myParentStaff->setParentItem(myParentSystem);
         height += layout->getStaffHeight();
 
-        if (isFirstStaff)
-            drawBarNumber(systemIndex, *layout);
-
-        // Draw the clefs.
-        const double CLEF_OFFSET =
-            (staff.getClefType() == Staff::TrebleClef) ? -6 : -21;
-        auto pubsub = myScoreArea->getClickPubSub();
-        const ScoreLocation location(myScore, systemIndex, i);
-        auto clef = new SimpleTextItem(staff.getClefType() == Staff::TrebleClef
-                                           ? QChar(MusicFont::TrebleClef)
-                                           : QChar(MusicFont::BassClef),
-                                       myMusicNotationFont);
-        auto group = new ClickableGroup(
-            QObject::tr("Click to change clef type."), [=]() {
-            pubsub->publish(ClickType::Clef, location);
-        });
-        group->addToGroup(clef);
-        group->setPos(LayoutInfo::CLEF_PADDING,
-                      layout->getTopStdNotationLine() + CLEF_OFFSET);
-        group->setParentItem(myParentStaff);
+        ++i;
+    }
+
+    myParentSystem->setRect(0, 0, LayoutInfo::STAFF_WIDTH, height);
+    return myParentSystem;
+}
+
+bool SystemRenderer::redrawStaff(QGraphicsItem *systemItem,
+                                 const System &system, int systemIndex,
+                                 int staffIndex)
+{
+    StaffPainter *oldStaff = nullptr;
+    bool isFirstStaff = true;
+    for (QGraphicsItem *child : systemItem->childItems())
+    {
+        auto staffPainter = qgraphicsitem_cast<StaffPainter *>(child);
+        if (!staffPainter)
+            continue;
+
+        const int index = staffPainter->getLocation().getStaffIndex();
+        if (index == staffIndex)
+            oldStaff = staffPainter;
+        else if (index < staffIndex)
+            isFirstStaff = false;
+    }
 
-        drawTabClef(LayoutInfo::CLEF_PADDING, *layout, location);
+    // The staff is hidden by the current filter.
+    if (!oldStaff)
+        return true;
 
+    const Staff &staff = system.getStaves()[staffIndex];
+    LayoutConstPtr layout = std::make_shared<LayoutInfo>(
+        myScore, system, systemIndex, staff, staffIndex);
+
+    // If the staff's height or the position spacing has changed, the other
+    // staves and the system symbols must be redrawn as well.
+    const LayoutInfo &oldLayout = oldStaff->getLayout();
+    if (layout->getStaffHeight() != oldLayout.getStaffHeight() ||
+        layout->getPositionSpacing() != oldLayout.getPositionSpacing() ||
+        layout->getSystemSymbolSpacing() != oldLayout.getSystemSymbolSpacing())
+    {
+        return false;
+    }
+
+    // Keep the existing system-level items.
+    myParentSystem = nullptr;
+
+    drawStaff(system, systemIndex, staff, staffIndex, layout, isFirstStaff);
+    myParentStaff->setPos(oldStaff->pos());
+    delete oldStaff;
+    myParentStaff->setParentItem(systemItem);
+
+    return true;
+}
+
+void SystemRenderer::drawStaff(const System &system, int systemIndex,
+                               const Staff &staff, int staffIndex,
+                               const LayoutConstPtr &layout, bool isFirstStaff)
+{
+    myParentStaff = new StaffPainter(
+        layout, ScoreLocation(myScore, systemIndex, staffIndex));
+
+    if (isFirstStaff)
+        drawBarNumber(systemIndex, *layout);
+
+    const ViewOptions::DetailLevel detail = myViewOptions.getDetailLevel();
+    const ScoreLocation location(myScore, systemIndex, staffIndex);
+
+    if (detail == ViewOptions::DetailLevel::Overview)
+    {
         drawBarlines(system, systemIndex, layout, isFirstStaff);
-        drawTabNotes(staff, layout);
+        drawRhythmStrokes(staff, *layout);
+        return;
+    }
+
+    // Draw the clefs.
+    const double CLEF_OFFSET =
+        (staff.getClefType() == Staff::TrebleClef) ? -6 : -21;
+    auto pubsub = myPubSub;
+    auto clef = new SimpleTextItem(staff.getClefType() == Staff::TrebleClef
+                                       ? QChar(MusicFont::TrebleClef)
+                                       : QChar(MusicFont::BassClef),
+                                   myMusicNotationFont);
+    auto group = new ClickableGroup(
+        QObject::tr("Click to change clef type."), [=]() {
+        pubsub->publish(ClickType::Clef, location);
+    });
+    group->addToGroup(clef);
+    group->setPos(LayoutInfo::CLEF_PADDING,
+                  layout->getTopStdNotationLine() + CLEF_OFFSET);
+    group->setParentItem(myParentStaff);
+
+    drawTabClef(LayoutInfo::CLEF_PADDING, *layout, location);
+
+    drawBarlines(system, systemIndex, layout, isFirstStaff);
+    drawTabNotes(staff, layout);
+
+    if (detail == ViewOptions::DetailLevel::Full)
+    {
         drawLegato(staff, *layout);
         drawSlides(staff, *layout);
 
@@ -150,14 +225,10 @@ QGraphicsItem *SystemRenderer::operator()(const System &system,
         drawSymbolsAboveTabStaff(staff, *layout);
         drawSymbolsBelowTabStaff(*layout);
 
-        drawPlayerChanges(system, i, *layout);
-        drawStdNotation(system, staff, *layout);
-
-        ++i;
+        drawPlayerChanges(system, staffIndex, *layout);
     }
 
-    myParentSystem->setRect(0, 0, LayoutInfo::STAFF_WIDTH, height);
-    return myParentSystem;
+    drawStdNotation(system, staff, *layout);
 }
 
 void SystemRenderer::drawTabClef(double x, const LayoutInfo &layout,
@@ -171,7 +242,7 @@ void SystemRenderer::drawTabClef(double x, const LayoutInfo &layout,
 
     auto clef = new SimpleTextItem(QChar(MusicFont::TabClef), font);
 
-    auto pubsub = myScoreArea->getClickPubSub();
+    auto pubsub = myPubSub;
     auto group = new ClickableGroup(
         QObject::tr("Click to edit the number of strings."), [=]() {
         pubsub->publish(ClickType::TabClef, location);
@@ -211,7 +282,7 @@ void SystemRenderer::drawBarlines(const System &system, int systemIndex,
         const TimeSignature &timeSig = barline.getTimeSignature();
 
         BarlinePainter *barlinePainter = new BarlinePainter(layout, barline,
-                location, myScoreArea->getClickPubSub());
+                location, myPubSub);
 
         double x = layout->getPositionX(barline.getPosition());
         double keySigX = x + barlinePainter->boundingRect().width() - 1;
@@ -257,8 +328,7 @@ void SystemRenderer::drawBarlines(const System &system, int systemIndex,
         if (keySig.isVisible())
         {
             KeySignaturePainter *keySigPainter = new KeySignaturePainter(
-                        layout, keySig, location,
-                        myScoreArea->getClickPubSub());
+                        layout, keySig, location, myPubSub);
 
             keySigPainter->setPos(keySigX, layout->getTopStdNotationLine());
             keySigPainter->setParentItem(myParentStaff);
@@ -267,14 +337,15 @@ void SystemRenderer::drawBarlines(const System &system, int systemIndex,
         if (timeSig.isVisible())
         {
             TimeSignaturePainter *timeSigPainter = new TimeSignaturePainter(
-                        layout, timeSig, location,
-                        myScoreArea->getClickPubSub());
+                        layout, timeSig, location, myPubSub);
 
             timeSigPainter->setPos(timeSigX, layout->getTopStdNotationLine());
             timeSigPainter->setParentItem(myParentStaff);
         }
 
-        if (barline.hasRehearsalSign() && isFirstStaff)
+        // Rehearsal signs belong to the system, and are not redrawn when only
+        // a single staff is redrawn.
+        if (barline.hasRehearsalSign() && isFirstStaff && myParentSystem)
         {
             const RehearsalSign &sign = barline.getRehearsalSign();
             const int RECTANGLE_OFFSET = 4;
@@ -356,6 +427,43 @@ void SystemRenderer::drawTabNotes(const Staff &staff,
     }
 }
 
+void SystemRenderer::drawRhythmStrokes(const Staff &staff,
+                                       const LayoutInfo &layout)
+{
+    // Build a single path for the whole staff rather than an item per note.
+    QPainterPath path;
+
+    for (const Voice &voice : staff.getVoices())
+    {
+        for (const Position &pos : voice.getPositions())
+        {
+            if (pos.isRest() || pos.getNotes().empty())
+                continue;
+
+            int minString = pos.getNotes().front().getString();
+            int maxString = minString;
+            for (const Note &note : pos.getNotes())
+            {
+                minString = std::min(minString, note.getString());
+                maxString = std::max(maxString, note.getString());
+            }
+
+            const double x = layout.getPositionX(pos.getPosition()) +
+                             0.5 * layout.getPositionSpacing();
+            path.moveTo(x, layout.getTabLine(minString + 1));
+            path.lineTo(x, layout.getTabLine(maxString + 1));
+
+            // Add a stem in the standard notation staff to show the rhythm.
+            path.moveTo(x, layout.getTopStdNotationLine());
+            path.lineTo(x, layout.getBottomStdNotationLine());
+        }
+    }
+
+    auto strokes = new QGraphicsPathItem(path);
+    strokes->setPen(QPen(Qt::black, 2));
+    strokes->setParentItem(myParentStaff);
+}
+
 void SystemRenderer::drawArpeggio(const Position &position, double x,
                                   const LayoutInfo& layout)
 {
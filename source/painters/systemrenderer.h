@@ -19,16 +19,17 @@
 #define PAINTERS_SYSTEMRENDERER_H
 
 #include <map>
+#include <memory>
 #include <painters/layoutinfo.h>
 #include <painters/musicfont.h>
 #include <QFontMetricsF>
 #include <score/staff.h>
 
+class ClickPubSub;
 class QGraphicsItem;
 class QGraphicsItemGroup;
 class QGraphicsRectItem;
 class Score;
-class ScoreArea;
 class ScoreLocation;
 class System;
 class ViewOptions;
@@ -36,12 +37,24 @@ class ViewOptions;
 class SystemRenderer
 {
 public:
-    SystemRenderer(const ScoreArea *score_area, const Score &score,
-                   const ViewOptions &view_options);
+    SystemRenderer(const std::shared_ptr<ClickPubSub> &pubsub,
+                   const Score &score, const ViewOptions &view_options);
 
     QGraphicsItem *operator()(const System &system, int systemIndex);
 
+    /// Replaces the items for a single staff in a system that was previously
+    /// rendered.
+    /// @return False if the change affects the layout of the other staves, in
+    /// which case the entire system must be redrawn.
+    bool redrawStaff(QGraphicsItem *systemItem, const System &system,
+                     int systemIndex, int staffIndex);
+
 private:
+    /// Creates the staff item (myParentStaff) and draws its contents.
+    void drawStaff(const System &system, int systemIndex, const Staff &staff,
+                   int staffIndex, const LayoutConstPtr &layout,
+                   bool isFirstStaff);
+
     /// Draws the tab clef.
     void drawTabClef(double x, const LayoutInfo &layout,
                      const ScoreLocation &location);
@@ -53,6 +66,10 @@ private:
     /// Draws the tab notes for all notes in the staff.
     void drawTabNotes(const Staff &staff, const LayoutConstPtr &layout);
 
+    /// Draws a single stroke for each position, in place of the notes. This is
+    /// used when zoomed out too far for the notes to be legible.
+    void drawRhythmStrokes(const Staff &staff, const LayoutInfo &layout);
+
     /// Centers an item, by using its width to calculate the necessary
     /// offset from xmin.
     static void centerHorizontally(QGraphicsItem &item, double xmin,
@@ -188,7 +205,7 @@ private:
     void drawSlide(const LayoutInfo &layout, int string, bool slideUp,
                    int position1, int position2) const;
 
-    const ScoreArea *myScoreArea;
+    const std::shared_ptr<ClickPubSub> myPubSub;
     const Score &myScore;
     const ViewOptions &myViewOptions;
 
@@ -0,0 +1,265 @@
+/*
+  * Copyright (C) 2016 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tilecache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <QPainter>
+#include <QRegion>
+#include <QRunnable>
+#include <QThread>
+#include <tuple>
+#include <utility>
+
+const int TileCache::TILE_SIZE = 256;
+// About 64MB of tiles.
+const size_t TileCache::MAX_TILES = 256;
+
+/// Rasterizes a single tile from a recording of the system.
+class TileCache::RenderTask : public QRunnable
+{
+public:
+    RenderTask(TileCache &cache, const TileKey &key, int generation,
+               const QPicture &picture, double scale)
+        : myCache(cache),
+          myKey(key),
+          myGeneration(generation),
+          myPicture(picture),
+          myScale(scale)
+    {
+    }
+
+    void run() override
+    {
+        QImage image(TILE_SIZE, TILE_SIZE, QImage::Format_ARGB32_Premultiplied);
+        image.fill(Qt::transparent);
+
+        QPainter painter(&image);
+        painter.setRenderHint(QPainter::Antialiasing);
+        painter.setRenderHint(QPainter::TextAntialiasing);
+        painter.translate(-myKey.myColumn * TILE_SIZE,
+                          -myKey.myRow * TILE_SIZE);
+        painter.scale(myScale, myScale);
+        painter.drawPicture(0, 0, myPicture);
+        painter.end();
+
+        myCache.storeTile(myKey, myGeneration, image);
+    }
+
+private:
+    TileCache &myCache;
+    const TileKey myKey;
+    const int myGeneration;
+    /// QPicture is implicitly shared, so this is a cheap copy that is not
+    /// affected if the system is redrawn while the task is running.
+    const QPicture myPicture;
+    const double myScale;
+};
+
+bool TileCache::TileKey::operator<(const TileKey &other) const
+{
+    return std::tie(mySystem, myZoom, myColumn, myRow) <
+           std::tie(other.mySystem, other.myZoom, other.myColumn,
+                    other.myRow);
+}
+
+TileCache::TileCache(QObject *parent)
+    : QObject(parent), myUseCounter(0), myNextGeneration(0)
+{
+    // Leave a core free for the GUI thread.
+    myThreadPool.setMaxThreadCount(
+        std::max(QThread::idealThreadCount() - 1, 1));
+}
+
+TileCache::~TileCache()
+{
+    myThreadPool.clear();
+    myThreadPool.waitForDone();
+}
+
+void TileCache::clear()
+{
+    myThreadPool.clear();
+    mySystems.clear();
+
+    std::lock_guard<std::mutex> lock(myMutex);
+    myGenerations.clear();
+    myTiles.clear();
+    myPendingTiles.clear();
+}
+
+void TileCache::addSystem(const QPicture &picture, const QSizeF &size)
+{
+    std::lock_guard<std::mutex> lock(myMutex);
+
+    SystemEntry entry;
+    entry.myPicture = picture;
+    entry.mySize = size;
+    entry.myGeneration = myNextGeneration++;
+
+    mySystems.push_back(entry);
+    myGenerations.push_back(entry.myGeneration);
+}
+
+void TileCache::setSystem(int index, const QPicture &picture,
+                          const QSizeF &size)
+{
+    std::lock_guard<std::mutex> lock(myMutex);
+
+    SystemEntry &entry = mySystems.at(index);
+    entry.myPicture = picture;
+    entry.mySize = size;
+    entry.myGeneration = myNextGeneration++;
+    myGenerations.at(index) = entry.myGeneration;
+
+    removeTiles(index);
+}
+
+void TileCache::draw(QPainter &painter, int index, const QPointF &systemPos,
+                     const QRectF &exposed, double scale)
+{
+    const SystemEntry &system = mySystems.at(index);
+    const QRectF bounds(systemPos, system.mySize);
+    const QRectF area = bounds.intersected(exposed);
+    if (area.isEmpty())
+        return;
+
+    // Find the tiles (in device pixels, relative to the system's origin) that
+    // cover the exposed area.
+    const int zoom = static_cast<int>(std::round(scale * 1000));
+    const double tileSize = TILE_SIZE / scale;
+    const QRectF local = area.translated(-systemPos);
+    const int firstColumn = static_cast<int>(std::floor(local.left() / tileSize));
+    const int lastColumn = static_cast<int>(std::floor(local.right() / tileSize));
+    const int firstRow = static_cast<int>(std::floor(local.top() / tileSize));
+    const int lastRow = static_cast<int>(std::floor(local.bottom() / tileSize));
+
+    // Look up the tiles while holding the lock, but do the painting
+    // afterwards so that the workers aren't blocked from storing tiles.
+    // QImage is implicitly shared, so the copies are cheap.
+    std::vector<std::pair<QRectF, QImage>> tiles;
+    QRegion missing;
+    {
+        std::lock_guard<std::mutex> lock(myMutex);
+
+        for (int row = firstRow; row <= lastRow; ++row)
+        {
+            for (int column = firstColumn; column <= lastColumn; ++column)
+            {
+                const TileKey key = { index, zoom, column, row };
+                const QRectF target(systemPos.x() + column * tileSize,
+                                    systemPos.y() + row * tileSize, tileSize,
+                                    tileSize);
+
+                auto it = myTiles.find(key);
+                if (it != myTiles.end())
+                {
+                    it->second.myLastUsed = ++myUseCounter;
+                    tiles.emplace_back(target, it->second.myImage);
+                }
+                else
+                {
+                    requestTile(key, system, scale);
+                    missing += target.intersected(bounds).toAlignedRect();
+                }
+            }
+        }
+    }
+
+    for (const auto &tile : tiles)
+        painter.drawImage(tile.first, tile.second);
+
+    // Until the missing tiles are ready, draw the recording directly. This is
+    // done once for all of the missing tiles.
+    if (!missing.isEmpty())
+    {
+        painter.save();
+        painter.setClipRegion(missing);
+        painter.translate(systemPos);
+        painter.drawPicture(0, 0, system.myPicture);
+        painter.restore();
+    }
+}
+
+void TileCache::requestTile(const TileKey &key, const SystemEntry &system,
+                            double scale)
+{
+    if (myPendingTiles.find(key) != myPendingTiles.end())
+        return;
+
+    myPendingTiles.insert(key);
+    myThreadPool.start(new RenderTask(*this, key, system.myGeneration,
+                                      system.myPicture, scale));
+}
+
+void TileCache::storeTile(const TileKey &key, int generation,
+                          const QImage &image)
+{
+    {
+        std::lock_guard<std::mutex> lock(myMutex);
+
+        // Ignore tiles for systems that have since been redrawn or removed.
+        if (key.mySystem >= static_cast<int>(myGenerations.size()) ||
+            myGenerations[key.mySystem] != generation)
+        {
+            return;
+        }
+
+        myPendingTiles.erase(key);
+        CachedTile &tile = myTiles[key];
+        tile.myImage = image;
+        tile.myLastUsed = ++myUseCounter;
+
+        evictTiles();
+    }
+
+    emit tileReady();
+}
+
+void TileCache::removeTiles(int index)
+{
+    for (auto it = myTiles.begin(); it != myTiles.end();)
+    {
+        if (it->first.mySystem == index)
+            it = myTiles.erase(it);
+        else
+            ++it;
+    }
+
+    for (auto it = myPendingTiles.begin(); it != myPendingTiles.end();)
+    {
+        if (it->mySystem == index)
+            it = myPendingTiles.erase(it);
+        else
+            ++it;
+    }
+}
+
+void TileCache::evictTiles()
+{
+    while (myTiles.size() > MAX_TILES)
+    {
+        auto oldest = std::min_element(
+            myTiles.begin(), myTiles.end(),
+            [](const std::pair<const TileKey, CachedTile> &a,
+               const std::pair<const TileKey, CachedTile> &b) {
+                return a.second.myLastUsed < b.second.myLastUsed;
+            });
+        myTiles.erase(oldest);
+    }
+}
@@ -0,0 +1,124 @@
+/*
+  * Copyright (C) 2016 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PAINTERS_TILECACHE_H
+#define PAINTERS_TILECACHE_H
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <QImage>
+#include <QObject>
+#include <QPicture>
+#include <QThreadPool>
+#include <set>
+#include <vector>
+
+class QPainter;
+
+/// Caches rasterized copies of the rendered systems, split into fixed-size
+/// tiles for each zoom level. Tiles are rasterized on background threads from
+/// a recording of the system, so scrolling only needs to blit images instead
+/// of repainting every item in the exposed area.
+class TileCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    /// Width and height of a tile, in device pixels.
+    static const int TILE_SIZE;
+    /// Maximum number of tiles that are kept in memory.
+    static const size_t MAX_TILES;
+
+    explicit TileCache(QObject *parent = nullptr);
+    ~TileCache();
+
+    /// Discards all systems and tiles.
+    void clear();
+
+    /// Adds a system after the existing systems.
+    void addSystem(const QPicture &picture, const QSizeF &size);
+
+    /// Replaces the recording of a system, and discards all of its tiles.
+    void setSystem(int index, const QPicture &picture, const QSizeF &size);
+
+    /// Draws the part of the system that intersects the exposed area. The
+    /// painter is expected to use scene coordinates, and the scale is the
+    /// view's zoom factor.
+    void draw(QPainter &painter, int index, const QPointF &systemPos,
+              const QRectF &exposed, double scale);
+
+signals:
+    /// Emitted (from a worker thread) when a tile has finished rendering.
+    void tileReady();
+
+private:
+    struct TileKey
+    {
+        int mySystem;
+        int myZoom;
+        int myColumn;
+        int myRow;
+
+        bool operator<(const TileKey &other) const;
+    };
+
+    struct SystemEntry
+    {
+        QPicture myPicture;
+        QSizeF mySize;
+        /// Incremented whenever the system is redrawn, so that stale tiles
+        /// from an earlier recording are discarded.
+        int myGeneration;
+    };
+
+    struct CachedTile
+    {
+        QImage myImage;
+        uint64_t myLastUsed;
+    };
+
+    class RenderTask;
+
+    /// Schedules a tile to be rendered in the background.
+    void requestTile(const TileKey &key, const SystemEntry &system,
+                     double scale);
+
+    /// Stores a finished tile, unless its system has since been redrawn.
+    void storeTile(const TileKey &key, int generation, const QImage &image);
+
+    /// Removes all tiles for the given system.
+    void removeTiles(int index);
+
+    /// Removes the least recently used tiles until under the memory budget.
+    void evictTiles();
+
+    /// Accessed only from the GUI thread.
+    std::vector<SystemEntry> mySystems;
+
+    /// Guards the state below, which is shared with the worker threads.
+    std::mutex myMutex;
+    std::vector<int> myGenerations;
+    std::map<TileKey, CachedTile> myTiles;
+    std::set<TileKey> myPendingTiles;
+    uint64_t myUseCounter;
+    int myNextGeneration;
+
+    QThreadPool myThreadPool;
+};
+
+#endif
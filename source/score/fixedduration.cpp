@@ -0,0 +1,139 @@
+/*
+  * Copyright (C) 2016 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "fixedduration.h"
+
+const int FixedDuration::TICKS_PER_QUARTER;
+
+FixedDuration::FixedDuration() : myTicks(0)
+{
+}
+
+FixedDuration::FixedDuration(int ticks) : myTicks(ticks)
+{
+}
+
+FixedDuration::FixedDuration(const boost::rational<int> &duration)
+    : myTicks(0), myRemainder(duration)
+{
+    normalize();
+}
+
+bool FixedDuration::operator==(const FixedDuration &other) const
+{
+    return myTicks == other.myTicks && myRemainder == other.myRemainder;
+}
+
+bool FixedDuration::operator!=(const FixedDuration &other) const
+{
+    return !(*this == other);
+}
+
+bool FixedDuration::operator<(const FixedDuration &other) const
+{
+    // The remainder is always less than one tick, so it only matters if the
+    // tick counts are equal.
+    if (myTicks != other.myTicks)
+        return myTicks < other.myTicks;
+    else if (isExact() && other.isExact())
+        return false;
+    else
+        return myRemainder < other.myRemainder;
+}
+
+bool FixedDuration::operator>(const FixedDuration &other) const
+{
+    return other < *this;
+}
+
+bool FixedDuration::operator<=(const FixedDuration &other) const
+{
+    return !(other < *this);
+}
+
+bool FixedDuration::operator>=(const FixedDuration &other) const
+{
+    return !(*this < other);
+}
+
+FixedDuration &FixedDuration::operator+=(const FixedDuration &other)
+{
+    myTicks += other.myTicks;
+
+    if (!other.isExact())
+    {
+        myRemainder += other.myRemainder;
+        normalize();
+    }
+
+    return *this;
+}
+
+FixedDuration FixedDuration::operator+(const FixedDuration &other) const
+{
+    FixedDuration result(*this);
+    result += other;
+    return result;
+}
+
+FixedDuration FixedDuration::operator*(int factor) const
+{
+    FixedDuration result(myTicks * factor);
+
+    if (!isExact())
+    {
+        result.myRemainder = myRemainder * factor;
+        result.normalize();
+    }
+
+    return result;
+}
+
+int FixedDuration::convertTicks(int ticksPerQuarter) const
+{
+    if (isExact())
+    {
+        return static_cast<int>(static_cast<long long>(myTicks) *
+                                ticksPerQuarter / TICKS_PER_QUARTER);
+    }
+    else
+        return boost::rational_cast<int>(toRational() * ticksPerQuarter);
+}
+
+boost::rational<int> FixedDuration::toRational() const
+{
+    return boost::rational<int>(myTicks, TICKS_PER_QUARTER) + myRemainder;
+}
+
+double FixedDuration::toDouble() const
+{
+    return static_cast<double>(myTicks) / TICKS_PER_QUARTER +
+           boost::rational_cast<double>(myRemainder);
+}
+
+void FixedDuration::normalize()
+{
+    // Round down to a whole number of ticks, leaving a remainder that is
+    // between zero and one tick.
+    const boost::rational<int> ticks = myRemainder * TICKS_PER_QUARTER;
+    int wholeTicks = ticks.numerator() / ticks.denominator();
+    if (ticks.numerator() < 0 && ticks.numerator() % ticks.denominator() != 0)
+        --wholeTicks;
+
+    myTicks += wholeTicks;
+    myRemainder -= boost::rational<int>(wholeTicks, TICKS_PER_QUARTER);
+}
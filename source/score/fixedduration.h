@@ -0,0 +1,72 @@
+/*
+  * Copyright (C) 2016 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SCORE_FIXEDDURATION_H
+#define SCORE_FIXEDDURATION_H
+
+#include <boost/rational.hpp>
+
+/// A duration relative to a quarter note, which is stored as a whole number
+/// of ticks so that it can be added and compared without the gcd computations
+/// done by boost::rational. TICKS_PER_QUARTER is chosen so that the dotted
+/// durations and common irregular groupings are a whole number of ticks.
+/// Any other durations keep the leftover fraction of a tick as a rational, so
+/// the result is always exact.
+class FixedDuration
+{
+public:
+    static const int TICKS_PER_QUARTER = 3840;
+
+    FixedDuration();
+    explicit FixedDuration(int ticks);
+    explicit FixedDuration(const boost::rational<int> &duration);
+
+    bool operator==(const FixedDuration &other) const;
+    bool operator!=(const FixedDuration &other) const;
+    bool operator<(const FixedDuration &other) const;
+    bool operator>(const FixedDuration &other) const;
+    bool operator<=(const FixedDuration &other) const;
+    bool operator>=(const FixedDuration &other) const;
+
+    FixedDuration &operator+=(const FixedDuration &other);
+    FixedDuration operator+(const FixedDuration &other) const;
+    FixedDuration operator*(int factor) const;
+
+    /// Returns the number of whole ticks.
+    int getTicks() const { return myTicks; }
+    /// Returns whether the duration is a whole number of ticks.
+    bool isExact() const { return myRemainder.numerator() == 0; }
+
+    /// Converts the duration to a different resolution (e.g. the pulses per
+    /// quarter note of a MIDI file), rounding down.
+    int convertTicks(int ticksPerQuarter) const;
+    /// Returns the duration in quarter notes.
+    boost::rational<int> toRational() const;
+    /// Returns the duration in quarter notes.
+    double toDouble() const;
+
+private:
+    /// Moves any whole ticks from the remainder into the tick count.
+    void normalize();
+
+    int myTicks;
+    /// The fraction of a quarter note that is left over, which is always
+    /// less than one tick.
+    boost::rational<int> myRemainder;
+};
+
+#endif
@@ -36,19 +36,25 @@ namespace {
     };
 }
 
-Note::Note()
-    : myString(0),
-      myFretNumber(0),
-      myTrilledFret(-1),
-      myTappedHarmonicFret(-1)
+Note::RareProperties::RareProperties()
+    : myTrilledFret(-1), myTappedHarmonicFret(-1)
+{
+}
+
+bool Note::RareProperties::operator==(const RareProperties &other) const
+{
+    return myTrilledFret == other.myTrilledFret &&
+           myTappedHarmonicFret == other.myTappedHarmonicFret &&
+           myArtificialHarmonic == other.myArtificialHarmonic &&
+           myBend == other.myBend;
+}
+
+Note::Note() : myString(0), myFretNumber(0)
 {
 }
 
 Note::Note(int string, int fretNumber)
-    : myString(string),
-      myFretNumber(fretNumber),
-      myTrilledFret(-1),
-      myTappedHarmonicFret(-1)
+    : myString(string), myFretNumber(fretNumber)
 {
 }
 
@@ -56,10 +62,7 @@ bool Note::operator==(const Note &other) const
 {
     return myString == other.myString && myFretNumber == other.myFretNumber &&
            mySimpleProperties == other.mySimpleProperties &&
-           myTrilledFret == other.myTrilledFret &&
-           myTappedHarmonicFret == other.myTappedHarmonicFret &&
-           myArtificialHarmonic == other.myArtificialHarmonic &&
-           myBend == other.myBend;
+           myRareProperties == other.myRareProperties;
 }
 
 int Note::getString() const
@@ -124,7 +127,7 @@ void Note::setProperty(SimpleProperty property, bool set)
 
 bool Note::hasTrill() const
 {
-    return myTrilledFret != -1;
+    return myRareProperties.get().myTrilledFret != -1;
 }
 
 int Note::getTrilledFret() const
@@ -132,7 +135,7 @@ int Note::getTrilledFret() const
     if (!hasTrill())
         throw std::logic_error("Note does not have a trill");
 
-    return myTrilledFret;
+    return myRareProperties.get().myTrilledFret;
 }
 
 void Note::setTrilledFret(int fret)
@@ -140,17 +143,19 @@ void Note::setTrilledFret(int fret)
     if (fret < 0)
         throw std::out_of_range("Invalid fret number");
 
-    myTrilledFret = fret;
+    myRareProperties.mutate().myTrilledFret = fret;
 }
 
 void Note::clearTrill()
 {
-    myTrilledFret = -1;
+    RareProperties properties = myRareProperties.get();
+    properties.myTrilledFret = -1;
+    setRareProperties(properties);
 }
 
 bool Note::hasTappedHarmonic() const
 {
-    return myTappedHarmonicFret != -1;
+    return myRareProperties.get().myTappedHarmonicFret != -1;
 }
 
 int Note::getTappedHarmonicFret() const
@@ -158,7 +163,7 @@ int Note::getTappedHarmonicFret() const
     if (!hasTappedHarmonic())
         throw std::logic_error("Note does not have a tapped harmonic");
 
-    return myTappedHarmonicFret;
+    return myRareProperties.get().myTappedHarmonicFret;
 }
 
 void Note::setTappedHarmonicFret(int fret)
@@ -166,52 +171,66 @@ void Note::setTappedHarmonicFret(int fret)
     if (fret < 0)
         throw std::out_of_range("Invalid fret number");
 
-    myTappedHarmonicFret = fret;
+    myRareProperties.mutate().myTappedHarmonicFret = fret;
 }
 
 void Note::clearTappedHarmonic()
 {
-    myTappedHarmonicFret = -1;
+    RareProperties properties = myRareProperties.get();
+    properties.myTappedHarmonicFret = -1;
+    setRareProperties(properties);
 }
 
 bool Note::hasArtificialHarmonic() const
 {
-    return myArtificialHarmonic.is_initialized();
+    return myRareProperties.get().myArtificialHarmonic.is_initialized();
 }
 
 const ArtificialHarmonic &Note::getArtificialHarmonic() const
 {
-    return myArtificialHarmonic.get();
+    return myRareProperties.get().myArtificialHarmonic.get();
 }
 
 void Note::setArtificialHarmonic(const ArtificialHarmonic &harmonic)
 {
-    myArtificialHarmonic = harmonic;
+    myRareProperties.mutate().myArtificialHarmonic = harmonic;
 }
 
 void Note::clearArtificialHarmonic()
 {
-    myArtificialHarmonic.reset();
+    RareProperties properties = myRareProperties.get();
+    properties.myArtificialHarmonic.reset();
+    setRareProperties(properties);
 }
 
 bool Note::hasBend() const
 {
-    return myBend.is_initialized();
+    return myRareProperties.get().myBend.is_initialized();
 }
 
 const Bend &Note::getBend() const
 {
-    return myBend.get();
+    return myRareProperties.get().myBend.get();
 }
 
 void Note::setBend(const Bend &bend)
 {
-    myBend = bend;
+    myRareProperties.mutate().myBend = bend;
 }
 
 void Note::clearBend()
 {
-    myBend.reset();
+    RareProperties properties = myRareProperties.get();
+    properties.myBend.reset();
+    setRareProperties(properties);
+}
+
+void Note::setRareProperties(const RareProperties &properties)
+{
+    if (properties == RareProperties())
+        myRareProperties.reset();
+    else if (!(properties == myRareProperties.get()))
+        myRareProperties.mutate() = properties;
 }
 
 std::ostream &operator<<(std::ostream &os, const Note &note)
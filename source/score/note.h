@@ -23,6 +23,7 @@
 #include "chordname.h"
 #include "fileversion.h"
 #include <iosfwd>
+#include <util/copyonwrite.h>
 #include <vector>
 
 class ArtificialHarmonic
@@ -205,13 +206,27 @@ public:
     static const int MAX_FRET_NUMBER;
 
 private:
+    /// Properties that very few notes have. These are only allocated for the
+    /// notes that use them, which keeps the common case small.
+    struct RareProperties
+    {
+        RareProperties();
+
+        bool operator==(const RareProperties &other) const;
+
+        int myTrilledFret;
+        int myTappedHarmonicFret;
+        boost::optional<ArtificialHarmonic> myArtificialHarmonic;
+        boost::optional<Bend> myBend;
+    };
+
+    /// Replaces the rare properties, and frees them if they are all unset.
+    void setRareProperties(const RareProperties &properties);
+
     int myString;
     int myFretNumber;
     std::bitset<NumSimpleProperties> mySimpleProperties;
-    int myTrilledFret;
-    int myTappedHarmonicFret;
-    boost::optional<ArtificialHarmonic> myArtificialHarmonic;
-    boost::optional<Bend> myBend;
+    CopyOnWrite<RareProperties> myRareProperties;
 };
 
 template <class Archive>
@@ -220,10 +235,13 @@ void Note::serialize(Archive &ar, const FileVersion /*version*/)
     ar("string", myString);
     ar("fret", myFretNumber);
     ar("properties", mySimpleProperties);
-    ar("trill", myTrilledFret);
-    ar("tapped_harmonic", myTappedHarmonicFret);
-    ar("artificial_harmonic", myArtificialHarmonic);
-    ar("bend", myBend);
+
+    RareProperties properties = myRareProperties.get();
+    ar("trill", properties.myTrilledFret);
+    ar("tapped_harmonic", properties.myTappedHarmonicFret);
+    ar("artificial_harmonic", properties.myArtificialHarmonic);
+    ar("bend", properties.myBend);
+    setRareProperties(properties);
 }
 
 /// Useful utility functions for working with natural and tapped harmonics.
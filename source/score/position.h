@@ -22,13 +22,16 @@
 #include <bitset>
 #include "fileversion.h"
 #include "note.h"
-#include <vector>
+#include <util/smallvector.h>
 
 class Position
 {
 public:
-    typedef std::vector<Note>::iterator NoteIterator;
-    typedef std::vector<Note>::const_iterator NoteConstIterator;
+    /// Most positions contain a single note or a small chord, so a few notes
+    /// are stored inline to avoid a heap allocation per position.
+    typedef SmallVector<Note, 2> NoteList;
+    typedef NoteList::iterator NoteIterator;
+    typedef NoteList::const_iterator NoteConstIterator;
 
     enum DurationType
     {
@@ -122,7 +125,7 @@ private:
     DurationType myDurationType;
     std::bitset<NumSimpleProperties> mySimpleProperties;
     int myMultiBarRestCount;
-    std::vector<Note> myNotes;
+    NoteList myNotes;
 };
 
 template <class Archive>
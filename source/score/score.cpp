@@ -17,11 +17,17 @@
 
 #include "score.h"
 
+#include <algorithm>
+#include <future>
+#include <thread>
+
 const int Score::MIN_LINE_SPACING = 6;
 const int Score::MAX_LINE_SPACING = 14;
 
 Score::Score()
-    : myLineSpacing(9)
+    : myLineSpacing(9),
+      myPlayerChangeIndexValid(false),
+      myStaffVisibilityValid(false)
 {
 }
 
@@ -60,11 +66,74 @@ void Score::insertSystem(const System &system, int index)
         mySystems.push_back(system);
     else
         mySystems.insert(mySystems.begin() + index, system);
+
+    invalidatePlayerChanges();
+}
+
+void Score::insertSystem(System &&system, int index)
+{
+    if (index < 0)
+        mySystems.push_back(std::move(system));
+    else
+        mySystems.insert(mySystems.begin() + index, std::move(system));
+
+    invalidatePlayerChanges();
+}
+
+void Score::shrinkToFit()
+{
+    mySystems.shrink_to_fit();
+
+    for (System &system : mySystems)
+        system.shrinkToFit();
 }
 
 void Score::removeSystem(int index)
 {
     mySystems.erase(mySystems.begin() + index);
+    invalidatePlayerChanges();
+}
+
+int Score::findPreviousPlayerChangeSystem(int systemIndex) const
+{
+    std::lock_guard<std::mutex> lock(myPlayerChangeMutex);
+
+    const int numSystems = static_cast<int>(mySystems.size());
+    systemIndex = std::max(0, std::min(systemIndex, numSystems));
+
+    // If a system has lost all of its player changes without the index being
+    // invalidated, rebuild it rather than returning a bad result.
+    if (myPlayerChangeIndexValid)
+    {
+        const int previous = myPlayerChangeIndex[systemIndex];
+        if (previous < 0 || !mySystems[previous].getPlayerChanges().empty())
+            return previous;
+    }
+
+    // Entry i holds the last system before i that has a player change. There
+    // is an extra entry for lookups past the end of the score.
+    myPlayerChangeIndex.resize(numSystems + 1);
+    int previous = -1;
+    for (int i = 0; i <= numSystems; ++i)
+    {
+        myPlayerChangeIndex[i] = previous;
+        if (i < numSystems && !mySystems[i].getPlayerChanges().empty())
+            previous = i;
+    }
+
+    myPlayerChangeIndexValid = true;
+    return myPlayerChangeIndex[systemIndex];
+}
+
+void Score::invalidatePlayerChanges()
+{
+    {
+        std::lock_guard<std::mutex> lock(myPlayerChangeMutex);
+        myPlayerChangeIndexValid = false;
+    }
+
+    // The filters depend on which players are active in each staff.
+    invalidateViewFilters();
 }
 
 boost::iterator_range<Score::PlayerIterator> Score::getPlayers()
@@ -80,16 +149,19 @@ boost::iterator_range<Score::PlayerConstIterator> Score::getPlayers() const
 void Score::insertPlayer(const Player &player)
 {
     myPlayers.push_back(player);
+    invalidateViewFilters();
 }
 
 void Score::insertPlayer(const Player &player, int index)
 {
     myPlayers.insert(myPlayers.begin() + index, player);
+    invalidateViewFilters();
 }
 
 void Score::removePlayer(int index)
 {
     myPlayers.erase(myPlayers.begin() + index);
+    invalidateViewFilters();
 }
 
 boost::iterator_range<Score::InstrumentIterator> Score::getInstruments()
@@ -130,11 +202,89 @@ boost::iterator_range<Score::ViewFilterConstIterator> Score::getViewFilters() co
 void Score::insertViewFilter(const ViewFilter &filter)
 {
     myViewFilters.push_back(filter);
+    invalidateViewFilters();
 }
 
 void Score::removeViewFilter(int index)
 {
     myViewFilters.erase(myViewFilters.begin() + index);
+    invalidateViewFilters();
+}
+
+bool Score::isStaffVisible(int filterIndex, int systemIndex,
+                           int staffIndex) const
+{
+    std::lock_guard<std::mutex> lock(myStaffVisibilityMutex);
+
+    const int numStaves =
+        static_cast<int>(mySystems[systemIndex].getStaves().size());
+
+    // Also recompute if staves were added or removed since the last query.
+    if (!myStaffVisibilityValid ||
+        myStaffVisibility.size() != mySystems.size() ||
+        myStaffVisibility[systemIndex].size() !=
+            myViewFilters.size() * static_cast<size_t>(numStaves))
+    {
+        computeStaffVisibility();
+    }
+
+    return myStaffVisibility[systemIndex][filterIndex * numStaves +
+                                          staffIndex];
+}
+
+void Score::invalidateViewFilters()
+{
+    std::lock_guard<std::mutex> lock(myStaffVisibilityMutex);
+    myStaffVisibilityValid = false;
+}
+
+void Score::computeStaffVisibility() const
+{
+    const int numSystems = static_cast<int>(mySystems.size());
+    myStaffVisibility.assign(numSystems, std::vector<bool>());
+
+    // Evaluating the rules (e.g. matching regular expressions against player
+    // names) is fairly expensive, so split the systems between threads. Each
+    // thread only writes to the entries for its own systems.
+    const int numThreads = std::max(
+        1, std::min(static_cast<int>(std::thread::hardware_concurrency()),
+                    numSystems));
+    const int workSize = numSystems / numThreads;
+
+    std::vector<std::future<void>> tasks;
+    for (int i = 0; i < numThreads; ++i)
+    {
+        const int left = i * workSize;
+        const int right =
+            (i == numThreads - 1) ? numSystems : (i + 1) * workSize;
+
+        tasks.push_back(std::async(std::launch::async, [=]() {
+            for (int system = left; system < right; ++system)
+            {
+                const int numStaves =
+                    static_cast<int>(mySystems[system].getStaves().size());
+                std::vector<bool> &visible = myStaffVisibility[system];
+                visible.resize(myViewFilters.size() * numStaves);
+
+                int filterIndex = 0;
+                for (const ViewFilter &filter : myViewFilters)
+                {
+                    for (int staff = 0; staff < numStaves; ++staff)
+                    {
+                        visible[filterIndex * numStaves + staff] =
+                            filter.accept(*this, system, staff);
+                    }
+
+                    ++filterIndex;
+                }
+            }
+        }));
+    }
+
+    for (auto &&task : tasks)
+        task.get();
+
+    myStaffVisibilityValid = true;
 }
 
 int Score::getLineSpacing() const
@@ -154,27 +304,27 @@ const PlayerChange *ScoreUtils::getCurrentPlayers(const Score &score,
                                                   int systemIndex,
                                                   int positionIndex)
 {
-    const PlayerChange *lastChange = nullptr;
-
-    int i = 0;
-    for (const System &system : score.getSystems())
+    // Look for a player change earlier in the current system.
+    if (systemIndex < static_cast<int>(score.getSystems().size()))
     {
-        if (i > systemIndex)
-            break;
-
-        for (const PlayerChange &change : system.getPlayerChanges())
+        const PlayerChange *lastChange = nullptr;
+        for (const PlayerChange &change :
+             score.getSystems()[systemIndex].getPlayerChanges())
         {
-            if (i < systemIndex ||
-               (i == systemIndex && change.getPosition() <= positionIndex))
-            {
+            if (change.getPosition() <= positionIndex)
                 lastChange = &change;
-            }
         }
 
-        ++i;
+        if (lastChange)
+            return lastChange;
     }
 
-    return lastChange;
+    // Otherwise, use the last player change from a previous system.
+    const int previous = score.findPreviousPlayerChangeSystem(systemIndex);
+    if (previous < 0)
+        return nullptr;
+
+    return &score.getSystems()[previous].getPlayerChanges().back();
 }
 
 void ScoreUtils::adjustRehearsalSigns(Score &score)
@@ -25,6 +25,7 @@
 #include "scoreinfo.h"
 #include "system.h"
 #include "viewfilter.h"
+#include <mutex>
 #include <vector>
 
 class Score
@@ -59,9 +60,23 @@ public:
 
     /// Adds a new system to the score, optionally at a specific index.
     void insertSystem(const System &system, int index = -1);
+    void insertSystem(System &&system, int index = -1);
     /// Removes the specified system from the score.
     void removeSystem(int index);
 
+    /// Releases any unused capacity in the systems, and reallocates each
+    /// system's contents in a single pass so that they are close together in
+    /// memory. This is done after a score has been imported.
+    void shrinkToFit();
+
+    /// Returns the index of the closest system before the given system that
+    /// has a player change, or -1 if there is none. This is used by
+    /// ScoreUtils::getCurrentPlayers(), and is O(1) once the index is built.
+    int findPreviousPlayerChangeSystem(int systemIndex) const;
+    /// Discards the player change index. This must be called when player
+    /// changes are added to or removed from a system.
+    void invalidatePlayerChanges();
+
     /// Returns the set of players in the score.
     boost::iterator_range<PlayerIterator> getPlayers();
     /// Returns the set of players in the score.
@@ -94,6 +109,14 @@ public:
     /// Removes the specified filter from the score.
     void removeViewFilter(int index);
 
+    /// Returns whether the specified filter accepts a staff. The first query
+    /// evaluates every filter for every staff in parallel, and the results
+    /// are then reused until the cache is invalidated.
+    bool isStaffVisible(int filterIndex, int systemIndex, int staffIndex) const;
+    /// Discards the cached filter results. This must be called when players
+    /// are modified, since the filters match against the players' settings.
+    void invalidateViewFilters();
+
     /// Returns the spacing between tabulature lines for the score.
     int getLineSpacing() const;
     /// Sets the spacing between tabulature lines for the score.
@@ -110,6 +133,20 @@ private:
     std::vector<Instrument> myInstruments;
     int myLineSpacing; ///< Spacing between tab lines (in pixels).
     std::vector<ViewFilter> myViewFilters;
+
+    /// For each system, the closest previous system with a player change.
+    /// This is built on demand, and may be accessed from multiple threads.
+    mutable std::vector<int> myPlayerChangeIndex;
+    mutable bool myPlayerChangeIndexValid;
+    mutable std::mutex myPlayerChangeMutex;
+
+    void computeStaffVisibility() const;
+
+    /// For each system, whether each staff is accepted by each filter. The
+    /// bits are grouped by filter, i.e. filter * numStaves + staff.
+    mutable std::vector<std::vector<bool>> myStaffVisibility;
+    mutable bool myStaffVisibilityValid;
+    mutable std::mutex myStaffVisibilityMutex;
 };
 
 template <class Archive>
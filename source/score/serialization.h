@@ -30,7 +30,9 @@
 #include <rapidjson/prettywriter.h>
 #include <stack>
 #include <stdexcept>
+#include <util/copyonwrite.h>
 #include <util/rapidjson_iostreams.h>
+#include <util/smallvector.h>
 #include <vector>
 
 namespace ScoreUtils
@@ -124,6 +126,12 @@ private:
     template <typename T>
     void read(std::vector<T> &vec);
 
+    template <typename T, size_t N>
+    void read(SmallVector<T, N> &vec);
+
+    template <typename Container>
+    void readArray(Container &vec);
+
     template <typename K, typename V, typename C>
     void read(std::map<K, V, C> &map);
 
@@ -136,6 +144,9 @@ private:
     template <typename T>
     void read(boost::optional<T> &val);
 
+    template <typename T>
+    void read(CopyOnWrite<T> &val);
+
     inline void read(boost::gregorian::date &date);
 
     template <typename T>
@@ -197,6 +208,12 @@ private:
     template <typename T>
     void write(const std::vector<T> &vec);
 
+    template <typename T, size_t N>
+    void write(const SmallVector<T, N> &vec);
+
+    template <typename Container>
+    void writeArray(const Container &vec);
+
     template <typename K, typename V, typename C>
     void write(const std::map<K, V, C> &map);
 
@@ -209,6 +226,9 @@ private:
     template <typename T>
     void write(const boost::optional<T> &val);
 
+    template <typename T>
+    void write(const CopyOnWrite<T> &val);
+
     inline void write(const boost::gregorian::date &date);
 
     template <typename T>
@@ -275,6 +295,18 @@ void InputArchive::read(std::string &str)
 
 template <typename T>
 void InputArchive::read(std::vector<T> &vec)
+{
+    readArray(vec);
+}
+
+template <typename T, size_t N>
+void InputArchive::read(SmallVector<T, N> &vec)
+{
+    readArray(vec);
+}
+
+template <typename Container>
+void InputArchive::readArray(Container &vec)
 {
     auto size = value().Size();
     myIterators.push(value().Begin());
@@ -342,6 +374,12 @@ void InputArchive::read(boost::optional<T> &val)
     }
 }
 
+template <typename T>
+void InputArchive::read(CopyOnWrite<T> &val)
+{
+    read(val.mutate());
+}
+
 void InputArchive::read(boost::gregorian::date &date)
 {
     std::string date_str;
@@ -372,9 +410,21 @@ void OutputArchive::write(const std::string &str)
 
 template <typename T>
 void OutputArchive::write(const std::vector<T> &vec)
+{
+    writeArray(vec);
+}
+
+template <typename T, size_t N>
+void OutputArchive::write(const SmallVector<T, N> &vec)
+{
+    writeArray(vec);
+}
+
+template <typename Container>
+void OutputArchive::writeArray(const Container &vec)
 {
     myStream.StartArray();
-    for (const T &obj : vec)
+    for (const auto &obj : vec)
         write(obj);
     myStream.EndArray();
 }
@@ -416,6 +466,12 @@ void OutputArchive::write(const boost::optional<T> &val)
         myStream.Null();
 }
 
+template <typename T>
+void OutputArchive::write(const CopyOnWrite<T> &val)
+{
+    write(val.get());
+}
+
 void OutputArchive::write(const boost::gregorian::date &date)
 {
     write(boost::gregorian::to_iso_string(date));
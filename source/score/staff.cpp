@@ -82,20 +82,20 @@ boost::iterator_range<Staff::VoiceConstIterator> Staff::getVoices() const
 
 boost::iterator_range<Staff::DynamicIterator> Staff::getDynamics()
 {
-    return boost::make_iterator_range(myDynamics);
+    return boost::make_iterator_range(myDynamics.mutate());
 }
 
 boost::iterator_range<Staff::DynamicConstIterator> Staff::getDynamics() const
 {
-    return boost::make_iterator_range(myDynamics);
+    return boost::make_iterator_range(myDynamics.get());
 }
 
 void Staff::insertDynamic(const Dynamic &dynamic)
 {
-    ScoreUtils::insertObject(myDynamics, dynamic);
+    ScoreUtils::insertObject(myDynamics.mutate(), dynamic);
 }
 
 void Staff::removeDynamic(const Dynamic &dynamic)
 {
-    ScoreUtils::removeObject(myDynamics, dynamic);
+    ScoreUtils::removeObject(myDynamics.mutate(), dynamic);
 }
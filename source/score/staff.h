@@ -22,6 +22,7 @@
 #include <boost/range/iterator_range_core.hpp>
 #include "dynamic.h"
 #include "fileversion.h"
+#include <util/copyonwrite.h>
 #include <vector>
 #include "voice.h"
 
@@ -83,7 +84,7 @@ private:
     ClefType myClefType;
     int myStringCount;
     std::array<Voice, NUM_VOICES> myVoices;
-    std::vector<Dynamic> myDynamics;
+    CopyOnWrite<std::vector<Dynamic>> myDynamics;
 };
 
 template <class Archive>
@@ -20,15 +20,17 @@
 #include <algorithm>
 #include <boost/range/adaptor/reversed.hpp>
 #include <cstddef>
+#include <functional>
 #include "utils.h"
 
 System::System()
 {
     // Add the start and end bars.
-    myBarlines.push_back(Barline());
+    std::vector<Barline> &barlines = myBarlines.mutate();
+    barlines.push_back(Barline());
     Barline endBar;
     endBar.setPosition(30);
-    myBarlines.push_back(endBar);
+    barlines.push_back(endBar);
 }
 
 bool System::operator==(const System &other) const
@@ -44,55 +46,80 @@ bool System::operator==(const System &other) const
 
 boost::iterator_range<System::StaffIterator> System::getStaves()
 {
-    return boost::make_iterator_range(myStaves);
+    return boost::make_iterator_range(myStaves.mutate());
 }
 
 boost::iterator_range<System::StaffConstIterator> System::getStaves() const
 {
-    return boost::make_iterator_range(myStaves);
+    return boost::make_iterator_range(myStaves.get());
 }
 
 void System::insertStaff(const Staff &staff)
 {
-    myStaves.push_back(staff);
+    myStaves.mutate().push_back(staff);
+}
+
+void System::insertStaff(Staff &&staff)
+{
+    myStaves.mutate().push_back(std::move(staff));
 }
 
 void System::insertStaff(const Staff &staff, int index)
 {
-    myStaves.insert(myStaves.begin() + index, staff);
+    std::vector<Staff> &staves = myStaves.mutate();
+    staves.insert(staves.begin() + index, staff);
+}
+
+void System::shrinkToFit()
+{
+    std::vector<Staff> &staves = myStaves.mutate();
+    staves.shrink_to_fit();
+
+    for (Staff &staff : staves)
+    {
+        for (Voice &voice : staff.getVoices())
+            voice.shrinkToFit();
+    }
+}
+
+size_t System::getStaffCapacity() const
+{
+    return myStaves.get().capacity();
 }
 
 void System::removeStaff(int index)
 {
-    myStaves.erase(myStaves.begin() + index);
+    std::vector<Staff> &staves = myStaves.mutate();
+    staves.erase(staves.begin() + index);
 }
 
 boost::iterator_range<System::BarlineIterator> System::getBarlines()
 {
-    return boost::make_iterator_range(myBarlines);
+    return boost::make_iterator_range(myBarlines.mutate());
 }
 
 boost::iterator_range<System::BarlineConstIterator> System::getBarlines() const
 {
-    return boost::make_iterator_range(myBarlines);
+    return boost::make_iterator_range(myBarlines.get());
 }
 
 void System::insertBarline(const Barline &barline)
 {
     // Ensure that the end bar remains the end bar.
-    myBarlines.back().setPosition(
-        std::max(myBarlines.back().getPosition(), barline.getPosition() + 1));
-    ScoreUtils::insertObject(myBarlines, barline);
+    std::vector<Barline> &barlines = myBarlines.mutate();
+    barlines.back().setPosition(
+        std::max(barlines.back().getPosition(), barline.getPosition() + 1));
+    ScoreUtils::insertObject(barlines, barline);
 }
 
 void System::removeBarline(const Barline &barline)
 {
-    ScoreUtils::removeObject(myBarlines, barline);
+    ScoreUtils::removeObject(myBarlines.mutate(), barline);
 }
 
 const Barline *System::getPreviousBarline(int position) const
 {
-    for (const Barline &barline : boost::adaptors::reverse(myBarlines))
+    for (const Barline &barline : boost::adaptors::reverse(myBarlines.get()))
     {
         if (barline.getPosition() < position)
             return &barline;
@@ -103,7 +130,7 @@ const Barline *System::getPreviousBarline(int position) const
 
 const Barline *System::getNextBarline(int position) const
 {
-    for (const Barline &barline : myBarlines)
+    for (const Barline &barline : myBarlines.get())
     {
         if (barline.getPosition() > position)
             return &barline;
@@ -114,7 +141,7 @@ const Barline *System::getNextBarline(int position) const
 
 Barline *System::getNextBarline(int position)
 {
-    for (Barline &barline : myBarlines)
+    for (Barline &barline : myBarlines.mutate())
     {
         if (barline.getPosition() > position)
             return &barline;
@@ -125,122 +152,122 @@ Barline *System::getNextBarline(int position)
 
 boost::iterator_range<System::TempoMarkerIterator> System::getTempoMarkers()
 {
-    return boost::make_iterator_range(myTempoMarkers);
+    return boost::make_iterator_range(myTempoMarkers.mutate());
 }
 
 boost::iterator_range<System::TempoMarkerConstIterator> System::getTempoMarkers() const
 {
-    return boost::make_iterator_range(myTempoMarkers);
+    return boost::make_iterator_range(myTempoMarkers.get());
 }
 
 void System::insertTempoMarker(const TempoMarker &marker)
 {
-    ScoreUtils::insertObject(myTempoMarkers, marker);
+    ScoreUtils::insertObject(myTempoMarkers.mutate(), marker);
 }
 
 void System::removeTempoMarker(const TempoMarker &marker)
 {
-    ScoreUtils::removeObject(myTempoMarkers, marker);
+    ScoreUtils::removeObject(myTempoMarkers.mutate(), marker);
 }
 
 boost::iterator_range<System::AlternateEndingIterator> System::getAlternateEndings()
 {
-    return boost::make_iterator_range(myAlternateEndings);
+    return boost::make_iterator_range(myAlternateEndings.mutate());
 }
 
 boost::iterator_range<System::AlternateEndingConstIterator> System::getAlternateEndings() const
 {
-    return boost::make_iterator_range(myAlternateEndings);
+    return boost::make_iterator_range(myAlternateEndings.get());
 }
 
 void System::insertAlternateEnding(const AlternateEnding &ending)
 {
-    ScoreUtils::insertObject(myAlternateEndings, ending);
+    ScoreUtils::insertObject(myAlternateEndings.mutate(), ending);
 }
 
 void System::removeAlternateEnding(const AlternateEnding &ending)
 {
-    ScoreUtils::removeObject(myAlternateEndings, ending);
+    ScoreUtils::removeObject(myAlternateEndings.mutate(), ending);
 }
 
 boost::iterator_range<System::DirectionIterator> System::getDirections()
 {
-    return boost::make_iterator_range(myDirections);
+    return boost::make_iterator_range(myDirections.mutate());
 }
 
 boost::iterator_range<System::DirectionConstIterator> System::getDirections() const
 {
-    return boost::make_iterator_range(myDirections);
+    return boost::make_iterator_range(myDirections.get());
 }
 
 void System::insertDirection(const Direction &direction)
 {
-    ScoreUtils::insertObject(myDirections, direction);
+    ScoreUtils::insertObject(myDirections.mutate(), direction);
 }
 
 void System::removeDirection(const Direction &direction)
 {
-    ScoreUtils::removeObject(myDirections, direction);
+    ScoreUtils::removeObject(myDirections.mutate(), direction);
 }
 
 boost::iterator_range<System::PlayerChangeIterator> System::getPlayerChanges()
 {
-    return boost::make_iterator_range(myPlayerChanges);
+    return boost::make_iterator_range(myPlayerChanges.mutate());
 }
 
 boost::iterator_range<System::PlayerChangeConstIterator> System::getPlayerChanges() const
 {
-    return boost::make_iterator_range(myPlayerChanges);
+    return boost::make_iterator_range(myPlayerChanges.get());
 }
 
 void System::insertPlayerChange(const PlayerChange &change)
 {
-    ScoreUtils::insertObject(myPlayerChanges, change);
+    ScoreUtils::insertObject(myPlayerChanges.mutate(), change);
 }
 
 void System::removePlayerChange(const PlayerChange &change)
 {
-    ScoreUtils::removeObject(myPlayerChanges, change);
+    ScoreUtils::removeObject(myPlayerChanges.mutate(), change);
 }
 
 boost::iterator_range<System::ChordTextIterator> System::getChords()
 {
-    return boost::make_iterator_range(myChords);
+    return boost::make_iterator_range(myChords.mutate());
 }
 
 boost::iterator_range<System::ChordTextConstIterator> System::getChords() const
 {
-    return boost::make_iterator_range(myChords);
+    return boost::make_iterator_range(myChords.get());
 }
 
 void System::insertChord(const ChordText &chord)
 {
-    ScoreUtils::insertObject(myChords, chord);
+    ScoreUtils::insertObject(myChords.mutate(), chord);
 }
 
 void System::removeChord(const ChordText &chord)
 {
-    ScoreUtils::removeObject(myChords, chord);
+    ScoreUtils::removeObject(myChords.mutate(), chord);
 }
 
 boost::iterator_range<System::TextItemIterator> System::getTextItems()
 {
-    return boost::make_iterator_range(myTextItems);
+    return boost::make_iterator_range(myTextItems.mutate());
 }
 
 boost::iterator_range<System::TextItemConstIterator> System::getTextItems() const
 {
-    return boost::make_iterator_range(myTextItems);
+    return boost::make_iterator_range(myTextItems.get());
 }
 
 void System::insertTextItem(const TextItem &text)
 {
-    ScoreUtils::insertObject(myTextItems, text);
+    ScoreUtils::insertObject(myTextItems.mutate(), text);
 }
 
 void System::removeTextItem(const TextItem &text)
 {
-    ScoreUtils::removeObject(myTextItems, text);
+    ScoreUtils::removeObject(myTextItems.mutate(), text);
 }
 
 template <typename T>
@@ -288,3 +315,71 @@ void SystemUtils::shiftBackward(System &system, int position)
 {
     shift(system, position, -1);
 }
+
+/// Adds the storage of a vector, which is shared between copies of the
+/// vector's owner.
+template <typename Range>
+static void addBlock(const Range &range, size_t size,
+                     std::vector<SystemUtils::MemoryBlock> &blocks)
+{
+    if (!range.empty())
+        blocks.push_back({ &*range.begin(), size });
+}
+
+template <typename Range>
+static void addBlock(const Range &range,
+                     std::vector<SystemUtils::MemoryBlock> &blocks)
+{
+    addBlock(range, range.size() * sizeof(*range.begin()), blocks);
+}
+
+/// Adds the blocks that are owned by the staff, not including the staff
+/// itself.
+static void addStaffBlocks(const Staff &staff,
+                           std::vector<SystemUtils::MemoryBlock> &blocks)
+{
+    addBlock(staff.getDynamics(), blocks);
+
+    for (const Voice &voice : staff.getVoices())
+    {
+        // Irregular groupings are usually stored inline, and are then already
+        // included in the size of the staff.
+        const auto groups = voice.getIrregularGroupings();
+        const std::less<const void *> before;
+        if (!groups.empty() && (before(&*groups.begin(), &voice) ||
+                                !before(&*groups.begin(), &voice + 1)))
+        {
+            addBlock(groups, blocks);
+        }
+
+        size_t size = 0;
+        for (const Position &pos : voice.getPositions())
+            size += sizeof(Position) + pos.getNotes().size() * sizeof(Note);
+
+        addBlock(voice.getPositions(), size, blocks);
+    }
+}
+
+void SystemUtils::getMemoryBlocks(const System &system,
+                                  std::vector<MemoryBlock> &blocks)
+{
+    blocks.push_back({ &system, sizeof(System) });
+    addBlock(system.getStaves(), blocks);
+    addBlock(system.getBarlines(), blocks);
+    addBlock(system.getTempoMarkers(), blocks);
+    addBlock(system.getAlternateEndings(), blocks);
+    addBlock(system.getDirections(), blocks);
+    addBlock(system.getPlayerChanges(), blocks);
+    addBlock(system.getChords(), blocks);
+    addBlock(system.getTextItems(), blocks);
+
+    for (const Staff &staff : system.getStaves())
+        addStaffBlocks(staff, blocks);
+}
+
+void SystemUtils::getMemoryBlocks(const Staff &staff,
+                                  std::vector<MemoryBlock> &blocks)
+{
+    blocks.push_back({ &staff, sizeof(Staff) });
+    addStaffBlocks(staff, blocks);
+}
@@ -28,8 +28,12 @@
 #include "staff.h"
 #include "tempomarker.h"
 #include "textitem.h"
+#include <util/copyonwrite.h>
 #include <vector>
 
+/// The contents of a system are shared between copies until they are modified,
+/// so snapshots of a system only cost memory for the parts that are later
+/// edited.
 class System
 {
 public:
@@ -64,10 +68,17 @@ public:
 
     /// Adds a new staff to the system.
     void insertStaff(const Staff &staff);
+    void insertStaff(Staff &&staff);
     void insertStaff(const Staff &staff, int index);
     /// Removes the specified staff from the system.
     void removeStaff(int index);
 
+    /// Releases any unused capacity in the staves and voices, e.g. after the
+    /// system has been built by an importer.
+    void shrinkToFit();
+    /// Returns the number of staves that can be stored without reallocating.
+    size_t getStaffCapacity() const;
+
     /// Returns the set of barlines in the system.
     boost::iterator_range<BarlineIterator> getBarlines();
     /// Returns the set of barlines in the system.
@@ -145,16 +156,16 @@ public:
     void removeTextItem(const TextItem &text);
 
 private:
-    std::vector<Staff> myStaves;
+    CopyOnWrite<std::vector<Staff>> myStaves;
     /// List of the barlines in the system. This will always contain at least
     /// two barlines - the start and end bars.
-    std::vector<Barline> myBarlines;
-    std::vector<TempoMarker> myTempoMarkers;
-    std::vector<AlternateEnding> myAlternateEndings;
-    std::vector<Direction> myDirections;
-    std::vector<PlayerChange> myPlayerChanges;
-    std::vector<ChordText> myChords;
-    std::vector<TextItem> myTextItems;
+    CopyOnWrite<std::vector<Barline>> myBarlines;
+    CopyOnWrite<std::vector<TempoMarker>> myTempoMarkers;
+    CopyOnWrite<std::vector<AlternateEnding>> myAlternateEndings;
+    CopyOnWrite<std::vector<Direction>> myDirections;
+    CopyOnWrite<std::vector<PlayerChange>> myPlayerChanges;
+    CopyOnWrite<std::vector<ChordText>> myChords;
+    CopyOnWrite<std::vector<TextItem>> myTextItems;
 };
 
 template <class Archive>
@@ -180,6 +191,19 @@ void shiftBackward(System &system, int position);
 /// Shifts everything by the given offset.
 void shift(System &system, int position, int offset);
 
+/// A block of memory used by a system. Copies of a system share blocks until
+/// they are modified, so blocks with the same data pointer should only be
+/// counted once.
+struct MemoryBlock
+{
+    const void *myData;
+    size_t mySize;
+};
+
+/// Adds an estimate of the memory used by the system or staff to the list.
+void getMemoryBlocks(const System &system, std::vector<MemoryBlock> &blocks);
+void getMemoryBlocks(const Staff &staff, std::vector<MemoryBlock> &blocks);
+
 }
 
 #endif
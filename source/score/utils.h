@@ -21,12 +21,13 @@
 #include <algorithm>
 #include <boost/range/adaptor/filtered.hpp>
 #include <boost/range/iterator_range_core.hpp>
+#include <iterator>
 
 namespace ScoreUtils {
 
     /// Returns the object at the given position index, or null.
     template <typename T>
-    typename T::pointer findByPosition(const boost::iterator_range<T> &range,
+    typename std::iterator_traits<T>::pointer findByPosition(const boost::iterator_range<T> &range,
                                        int position)
     {
         size_t n = range.size();
@@ -90,22 +91,27 @@ namespace ScoreUtils {
         }
     };
 
-    template <typename T>
-    void insertObject(std::vector<T> &objects, const T &obj)
+    template <typename Container, typename T>
+    void insertObject(Container &objects, T &&obj)
     {
+        typedef typename Container::value_type ValueType;
+
         // Avoid sorting unless we actually need to. This improves performance
         // quite a bit when, for example, we are importing from other file
         // formats and inserting objects in order.
         const bool needsSort = !objects.empty() &&
                 objects.back().getPosition() > obj.getPosition();
 
-        objects.push_back(obj);
+        objects.push_back(std::forward<T>(obj));
         if (needsSort)
-            std::sort(objects.begin(), objects.end(), OrderByPosition<T>());
+        {
+            std::sort(objects.begin(), objects.end(),
+                      OrderByPosition<ValueType>());
+        }
     }
 
-    template <typename T>
-    void removeObject(std::vector<T> &objects, const T &obj)
+    template <typename Container, typename T>
+    void removeObject(Container &objects, const T &obj)
     {
         objects.erase(std::remove(objects.begin(), objects.end(), obj),
                       objects.end());
@@ -17,6 +17,7 @@
 
 #include "repeatindexer.h"
 
+#include <algorithm>
 #include <score/score.h>
 #include <score/utils.h>
 #include <stack>
@@ -159,7 +160,7 @@ RepeatIndexer::RepeatIndexer(const Score &score)
                     activeRepeat.getAlternateEndingCount() >=
                         activeRepeat.getTotalRepeatCount())
                 {
-                    myRepeats.insert(activeRepeat);
+                    myRepeats.push_back(activeRepeat);
                     repeats.pop();
                 }
             }
@@ -183,7 +184,7 @@ RepeatIndexer::RepeatIndexer(const Score &score)
                 // done with this repeat.
                 if (activeRepeat.getAlternateEndingCount() == 0)
                 {
-                    myRepeats.insert(activeRepeat);
+                    myRepeats.push_back(activeRepeat);
                     repeats.pop();
                 }
             }
@@ -208,19 +209,48 @@ RepeatIndexer::RepeatIndexer(const Score &score)
 
     // TODO - report mismatched repeat start bars.
     // TODO - report missing / extra alternate endings.
+
+    // Sort the repeats by their start bar, ignoring any duplicates.
+    std::stable_sort(myRepeats.begin(), myRepeats.end());
+    myRepeats.erase(std::unique(myRepeats.begin(), myRepeats.end(),
+                                [](const RepeatedSection &a,
+                                   const RepeatedSection &b) {
+                                    return !(a < b) && !(b < a);
+                                }),
+                    myRepeats.end());
+
+    // Record the furthest end bar seen so far, so that findRepeat() can stop
+    // searching once no earlier repeat can surround the location.
+    myMaxEndBars.reserve(myRepeats.size());
+    for (const RepeatedSection &repeat : myRepeats)
+    {
+        if (myMaxEndBars.empty() ||
+            myMaxEndBars.back() < repeat.getLastEndBarLocation())
+        {
+            myMaxEndBars.push_back(repeat.getLastEndBarLocation());
+        }
+        else
+            myMaxEndBars.push_back(myMaxEndBars.back());
+    }
 }
 
 const RepeatedSection *RepeatIndexer::findRepeat(
     const SystemLocation &loc) const
 {
-    auto repeat = myRepeats.upper_bound(loc);
+    // Find the first repeat that starts after this location.
+    auto it = std::upper_bound(
+        myRepeats.begin(), myRepeats.end(), loc,
+        [](const SystemLocation &location, const RepeatedSection &repeat) {
+            return location < repeat.getStartBarLocation();
+        });
+    size_t i = it - myRepeats.begin();
 
     // Search for a pair of start and end bars that surrounds this location.
-    while (repeat != myRepeats.begin())
+    while (i > 0 && myMaxEndBars[i - 1] >= loc)
     {
-        --repeat;
-        if (repeat->getLastEndBarLocation() >= loc)
-            return &(*repeat);
+        --i;
+        if (myRepeats[i].getLastEndBarLocation() >= loc)
+            return &myRepeats[i];
     }
 
     return nullptr;
@@ -22,8 +22,8 @@
 #include <boost/range/iterator_range.hpp>
 #include <map>
 #include <score/systemlocation.h>
-#include <set>
 #include <unordered_map>
+#include <vector>
 
 class AlternateEnding;
 class Score;
@@ -77,7 +77,7 @@ private:
 class RepeatIndexer
 {
 public:
-    typedef std::set<RepeatedSection>::const_iterator RepeatedSectionIterator;
+    typedef std::vector<RepeatedSection>::const_iterator RepeatedSectionIterator;
 
     RepeatIndexer(const Score &score);
 
@@ -90,7 +90,10 @@ public:
     boost::iterator_range<RepeatedSectionIterator> getRepeats() const;
 
 private:
-    std::set<RepeatedSection> myRepeats;
+    /// The repeated sections, sorted by the location of their start bar.
+    std::vector<RepeatedSection> myRepeats;
+    /// The latest end bar among the first n repeats in myRepeats.
+    std::vector<SystemLocation> myMaxEndBars;
 };
 
 #endif
@@ -527,6 +527,7 @@ static void mergePlayerChanges(ScoreLocation &dest_loc,
             change.setPosition(dest_loc.getPositionIndex());
 
         dest_system.insertPlayerChange(change);
+        dest_loc.getScore().invalidatePlayerChanges();
     }
 }
 
@@ -17,12 +17,15 @@
 
 #include "scorepolisher.h"
 
-#include <map>
+#include <algorithm>
+#include <future>
 #include <score/score.h>
 #include <score/voiceutils.h>
 #include <score/utils.h>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 class TimeStamp
 {
@@ -42,7 +45,7 @@ public:
             return myTime < other.myTime;
     }
 
-    void advance(const boost::rational<int> &duration)
+    void advance(const FixedDuration &duration)
     {
         myTime += duration;
     }
@@ -54,15 +57,40 @@ public:
 
 private:
     /// The time from the start of the bar.
-    boost::rational<int> myTime;
+    FixedDuration myTime;
     /// Grace notes occur at the same timestamp as the note that they precede,
     /// but need to appear before the actual note.
     boost::optional<int> myGraceNoteNumber;
 };
 
-static int getDefaultNoteSpacing(const boost::rational<int> &duration)
+/// The position of each timestamp in a bar, sorted by timestamp. Bars have
+/// few timestamps, so a sorted vector is much cheaper than a std::map.
+typedef std::vector<std::pair<TimeStamp, int>> TimeStampPositions;
+
+/// Buffers that are reused for each bar, so that they are only allocated once
+/// per thread rather than once per bar.
+struct PolishScratch
+{
+    std::unordered_map<const Position *, TimeStamp> myTimestamps;
+    TimeStampPositions myTimestampPositions;
+    std::unordered_set<const void *> myKnownItems;
+};
+
+/// Returns the first entry that is not before the timestamp.
+static TimeStampPositions::iterator findTimestamp(
+    TimeStampPositions &timestampPositions, const TimeStamp &timestamp)
+{
+    return std::lower_bound(
+        timestampPositions.begin(), timestampPositions.end(), timestamp,
+        [](const std::pair<TimeStamp, int> &entry, const TimeStamp &t) {
+            return entry.first < t;
+        });
+}
+
+static int getDefaultNoteSpacing(const FixedDuration &duration)
 {
-    return std::max(2 * boost::rational_cast<int>(duration), 1);
+    return std::max(
+        2 * (duration.getTicks() / FixedDuration::TICKS_PER_QUARTER), 1);
 }
 
 template <typename T>
@@ -101,39 +129,48 @@ static void shiftAllItemsAtPosition(
                          newPosition, knownItems);
 }
 
-static void computeTimestampPosition(
-    const TimeStamp &timestamp, int minPosition,
-    std::map<TimeStamp, int> &timestampPositions)
+/// Computes the position for a timestamp, and returns the new position.
+static int computeTimestampPosition(const TimeStamp &timestamp,
+                                    int minPosition,
+                                    TimeStampPositions &timestampPositions)
 {
-    int position = 0;
-
     // If another voice has a note at this timestamp, use that position.
-    auto it = timestampPositions.find(timestamp);
-    if (it != timestampPositions.end())
-        position = std::max(it->second, minPosition);
-    else
+    auto it = findTimestamp(timestampPositions, timestamp);
+    if (it != timestampPositions.end() && !(timestamp < it->first))
     {
-        // If this timestamp falls in between two timestamps from another voice,
-        // insert it and shift the following timestamps over if necessary.
-        it = timestampPositions.lower_bound(timestamp);
-        if (it != timestampPositions.begin())
-        {
-            position = std::max(boost::prior(it)->second + 1, minPosition);
+        it->second = std::max(it->second, minPosition);
+        return it->second;
+    }
+
+    // If this timestamp falls in between two timestamps from another voice,
+    // insert it and shift the following timestamps over if necessary.
+    int position = 0;
+    if (it != timestampPositions.begin())
+    {
+        position = std::max(boost::prior(it)->second + 1, minPosition);
 
-            if (it != timestampPositions.end() && it->second <= position)
+        if (it != timestampPositions.end() && it->second <= position)
+        {
+            const int shiftAmount = (position - it->second) + 1;
+            for (auto shifted = it; shifted != timestampPositions.end();
+                 ++shifted)
             {
-                const int shiftAmount = (position - it->second) + 1;
-                for (; it != timestampPositions.end(); ++it)
-                    it->second += shiftAmount;
+                shifted->second += shiftAmount;
             }
         }
     }
 
-    timestampPositions[timestamp] = position;
+    timestampPositions.emplace(it, timestamp, position);
+    return position;
 }
 
-void ScoreUtils::polishSystem(System &system)
+static void polishSystem(System &system, PolishScratch &scratch)
 {
+    std::unordered_map<const Position *, TimeStamp> &timestamps =
+        scratch.myTimestamps;
+    TimeStampPositions &timestampPositions = scratch.myTimestampPositions;
+    std::unordered_set<const void *> &knownItems = scratch.myKnownItems;
+
     // Format each bar separately.
     for (Barline &leftBar : system.getBarlines())
     {
@@ -141,14 +178,17 @@ void ScoreUtils::polishSystem(System &system)
         if (!rightBar)
             break;
 
-        std::unordered_map<const Position *, TimeStamp> timestamps;
-        std::map<TimeStamp, int> timestampPositions;
+        timestamps.clear();
+        timestampPositions.clear();
+        knownItems.clear();
 
         // For each timestamp, compute the maximum position at that timestamp
-        // for any staff.
-        for (const Staff &staff : system.getStaves())
+        // for any staff. The timestamps are keyed by the positions' addresses,
+        // so use the mutable accessors to detach any positions that are shared
+        // with a copy of the system before taking their addresses.
+        for (Staff &staff : system.getStaves())
         {
-            for (const Voice &voice : staff.getVoices())
+            for (Voice &voice : staff.getVoices())
             {
                 TimeStamp timestamp;
                 boost::optional<int> grace_note;
@@ -165,13 +205,13 @@ void ScoreUtils::polishSystem(System &system)
 
                     timestamp.setGraceNoteNumber(grace_note);
 
-                    computeTimestampPosition(timestamp, currentPosition,
-                                             timestampPositions);
-                    boost::rational<int> duration =
-                        VoiceUtils::getDurationTime(voice, position);
+                    const int timestampPosition = computeTimestampPosition(
+                        timestamp, currentPosition, timestampPositions);
+                    const FixedDuration duration =
+                        VoiceUtils::getFixedDurationTime(voice, position);
 
-                    currentPosition = timestampPositions[timestamp] +
-                                      getDefaultNoteSpacing(duration);
+                    currentPosition =
+                        timestampPosition + getDefaultNoteSpacing(duration);
                     timestamps[&position] = timestamp;
                     timestamp.advance(duration);
                 }
@@ -184,14 +224,13 @@ void ScoreUtils::polishSystem(System &system)
 
         int maxPosition = 0;
         if (!timestampPositions.empty())
-            maxPosition = boost::prior(timestampPositions.end())->second;
+            maxPosition = timestampPositions.back().second;
 
         // Adjust!
         const int startPos =
             (leftBar.getPosition() == 0) ? 0 : leftBar.getPosition() + 1;
         const int oldEndPos = rightBar->getPosition();
         const int endPos = startPos + maxPosition;
-        std::unordered_set<const void *> knownItems;
 
         if (endPos > oldEndPos)
         {
@@ -221,10 +260,11 @@ void ScoreUtils::polishSystem(System &system)
                 {
                     // Since we're moving around irregular groups, we need to
                     // have precomputed the durations of each position.
-                    TimeStamp timestamp = timestamps[&pos];
+                    const TimeStamp &timestamp = timestamps[&pos];
                     const int currentPosition = pos.getPosition();
                     const int newPosition =
-                        startPos + timestampPositions[timestamp];
+                        startPos +
+                        findTimestamp(timestampPositions, timestamp)->second;
 
                     // Move any irregular groups, etc that start at this
                     // position. If the group moves forward, we need to be
@@ -240,8 +280,36 @@ void ScoreUtils::polishSystem(System &system)
     }
 }
 
+void ScoreUtils::polishSystem(System &system)
+{
+    PolishScratch scratch;
+    ::polishSystem(system, scratch);
+}
+
 void ScoreUtils::polishScore(Score &score)
 {
-    for (System &system : score.getSystems())
-        polishSystem(system);
+    // Each system is formatted independently, so split the systems between
+    // threads. Each thread has its own scratch buffers.
+    const int numSystems = static_cast<int>(score.getSystems().size());
+    const int numThreads = std::max(
+        1, std::min(static_cast<int>(std::thread::hardware_concurrency()),
+                    numSystems));
+    const int workSize = numSystems / numThreads;
+
+    std::vector<std::future<void>> tasks;
+    for (int i = 0; i < numThreads; ++i)
+    {
+        const int left = i * workSize;
+        const int right =
+            (i == numThreads - 1) ? numSystems : (i + 1) * workSize;
+
+        tasks.push_back(std::async(std::launch::async, [&score, left, right]() {
+            PolishScratch scratch;
+            for (int system = left; system < right; ++system)
+                ::polishSystem(score.getSystems()[system], scratch);
+        }));
+    }
+
+    for (auto &&task : tasks)
+        task.get();
 }
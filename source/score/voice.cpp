@@ -31,22 +31,27 @@ bool Voice::operator==(const Voice &other) const
 
 boost::iterator_range<Voice::PositionIterator> Voice::getPositions()
 {
-    return boost::make_iterator_range(myPositions);
+    return boost::make_iterator_range(myPositions.mutate());
 }
 
 boost::iterator_range<Voice::PositionConstIterator> Voice::getPositions() const
 {
-    return boost::make_iterator_range(myPositions);
+    return boost::make_iterator_range(myPositions.get());
 }
 
 void Voice::insertPosition(const Position &position)
 {
-    ScoreUtils::insertObject(myPositions, position);
+    ScoreUtils::insertObject(myPositions.mutate(), position);
+}
+
+void Voice::insertPosition(Position &&position)
+{
+    ScoreUtils::insertObject(myPositions.mutate(), std::move(position));
 }
 
 void Voice::removePosition(const Position &position)
 {
-    ScoreUtils::removeObject(myPositions, position);
+    ScoreUtils::removeObject(myPositions.mutate(), position);
 }
 
 boost::iterator_range<Voice::IrregularGroupingIterator>
@@ -70,3 +75,14 @@ void Voice::removeIrregularGrouping(const IrregularGrouping &group)
 {
     ScoreUtils::removeObject(myIrregularGroupings, group);
 }
+
+void Voice::shrinkToFit()
+{
+    if (myPositions.get().capacity() != myPositions.get().size())
+        myPositions.mutate().shrink_to_fit();
+}
+
+size_t Voice::getPositionCapacity() const
+{
+    return myPositions.get().capacity();
+}
@@ -22,8 +22,12 @@
 #include "fileversion.h"
 #include "irregulargrouping.h"
 #include "position.h"
+#include <util/copyonwrite.h>
+#include <util/smallvector.h>
 #include <vector>
 
+/// The positions are shared between copies of a voice until they are
+/// modified, so copying a voice (e.g. for an undo snapshot) is cheap.
 class Voice
 {
 public:
@@ -31,8 +35,11 @@ public:
 
     typedef std::vector<Position>::iterator PositionIterator;
     typedef std::vector<Position>::const_iterator PositionConstIterator;
-    typedef std::vector<IrregularGrouping>::iterator IrregularGroupingIterator;
-    typedef std::vector<IrregularGrouping>::const_iterator
+    /// Voices rarely have more than a few irregular groupings, so they are
+    /// stored inline in the voice rather than being shared between copies.
+    typedef SmallVector<IrregularGrouping, 4> IrregularGroupingList;
+    typedef IrregularGroupingList::iterator IrregularGroupingIterator;
+    typedef IrregularGroupingList::const_iterator
     IrregularGroupingConstIterator;
 
     bool operator==(const Voice &other) const;
@@ -47,6 +54,7 @@ public:
 
     /// Adds a new position to the voice.
     void insertPosition(const Position &position);
+    void insertPosition(Position &&position);
     /// Removes any positions that satisfy the given predicate.
     template <typename Predicate>
     void removePositions(Predicate p);
@@ -64,9 +72,16 @@ public:
     /// Removes the specified irregular grouping from the voice.
     void removeIrregularGrouping(const IrregularGrouping &group);
 
+    /// Releases any unused capacity, e.g. after the voice has been built by an
+    /// importer.
+    void shrinkToFit();
+    /// Returns the number of positions that can be stored without
+    /// reallocating.
+    size_t getPositionCapacity() const;
+
 private:
-    std::vector<Position> myPositions;
-    std::vector<IrregularGrouping> myIrregularGroupings;
+    CopyOnWrite<std::vector<Position>> myPositions;
+    IrregularGroupingList myIrregularGroupings;
 };
 
 template <class Archive>
@@ -79,8 +94,9 @@ void Voice::serialize(Archive &ar, const FileVersion /*version*/)
 template <typename Predicate>
 void Voice::removePositions(Predicate p)
 {
-    myPositions.erase(std::remove_if(myPositions.begin(), myPositions.end(), p),
-                      myPositions.end());
+    std::vector<Position> &positions = myPositions.mutate();
+    positions.erase(std::remove_if(positions.begin(), positions.end(), p),
+                    positions.end());
 }
 
 #endif
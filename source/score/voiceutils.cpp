@@ -156,4 +156,34 @@ boost::rational<int> getDurationTime(const Voice &voice, const Position &pos)
 
     return duration;
 }
+
+FixedDuration getFixedDurationTime(const Voice &voice, const Position &pos)
+{
+    if (pos.hasProperty(Position::Acciaccatura))
+        return FixedDuration();
+
+    int ticks = 4 * FixedDuration::TICKS_PER_QUARTER / pos.getDurationType();
+
+    // Adjust for dotted notes. The divisions are exact for durations down to
+    // a 64th note.
+    if (pos.hasProperty(Position::Dotted))
+        ticks += ticks / 2;
+    if (pos.hasProperty(Position::DoubleDotted))
+        ticks += ticks * 3 / 4;
+
+    // Adjust for irregular groups. If a group does not divide the duration
+    // evenly (e.g. 7 notes played in the time of 4), fall back to rational
+    // arithmetic.
+    for (const IrregularGrouping *group :
+         getIrregularGroupsInRange(voice, pos.getPosition(), pos.getPosition()))
+    {
+        const int scaled = ticks * group->getNotesPlayedOver();
+        if (scaled % group->getNotesPlayed() != 0)
+            return FixedDuration(getDurationTime(voice, pos));
+
+        ticks = scaled / group->getNotesPlayed();
+    }
+
+    return FixedDuration(ticks);
+}
 }
@@ -18,6 +18,7 @@
 #ifndef SCORE_VOICEUTILS_H
 #define SCORE_VOICEUTILS_H
 
+#include "fixedduration.h"
 #include "voice.h"
 
 #include <boost/rational.hpp>
@@ -64,6 +65,11 @@ std::vector<const IrregularGrouping *> getIrregularGroupsInRange(
 /// This does not include tempo, and the durations are relative to a
 /// quarter note (i.e. a quarter note is 1, eighth note is 1/2, etc).
 boost::rational<int> getDurationTime(const Voice &voice, const Position &pos);
+
+/// Returns the same duration as getDurationTime(), but as a FixedDuration.
+/// This avoids rational arithmetic unless the duration is not a whole number
+/// of ticks.
+FixedDuration getFixedDurationTime(const Voice &voice, const Position &pos);
 }
 
 #endif
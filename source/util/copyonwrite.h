@@ -0,0 +1,79 @@
+/*
+  * Copyright (C) 2016 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef UTIL_COPYONWRITE_H
+#define UTIL_COPYONWRITE_H
+
+#include <memory>
+
+/// Stores a value that is shared between copies until one of them is modified,
+/// so copying is O(1) regardless of the size of the value.
+/// References obtained from mutate() are only valid until the owner is next
+/// copied, since the copy will share the same data.
+template <typename T>
+class CopyOnWrite
+{
+public:
+    CopyOnWrite() = default;
+
+    bool operator==(const CopyOnWrite &other) const
+    {
+        return myData == other.myData || get() == other.get();
+    }
+
+    bool operator!=(const CopyOnWrite &other) const
+    {
+        return !(*this == other);
+    }
+
+    /// Returns the value for reading.
+    const T &get() const
+    {
+        return myData ? *myData : empty();
+    }
+
+    /// Returns the value for writing. If the value is shared with another
+    /// copy, a private copy is made first.
+    T &mutate()
+    {
+        if (!myData)
+            myData = std::make_shared<T>();
+        else if (myData.use_count() > 1)
+            myData = std::make_shared<T>(*myData);
+
+        return *myData;
+    }
+
+    /// Releases this copy's reference to the value, leaving a
+    /// default-constructed value.
+    void reset()
+    {
+        myData.reset();
+    }
+
+private:
+    /// Default-constructed values are not allocated until they are modified.
+    static const T &empty()
+    {
+        static const T theEmptyValue;
+        return theEmptyValue;
+    }
+
+    std::shared_ptr<T> myData;
+};
+
+#endif
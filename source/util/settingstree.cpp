@@ -19,6 +19,7 @@
 
 #include <boost/algorithm/string/classification.hpp>
 #include <boost/algorithm/string/split.hpp>
+#include <mutex>
 
 #include <rapidjson/document.h>
 #include <rapidjson/error/en.h>
@@ -243,14 +244,61 @@ private:
     rapidjson::PrettyWriter<decltype(myStream)> myWriter;
 };
 
+namespace
+{
+/// The keys of all settings that have been registered, indexed by slot.
+struct SettingRegistry
+{
+    std::mutex myMutex;
+    std::vector<std::string> myKeys;
+    std::unordered_map<std::string, int> mySlots;
+};
+
+SettingRegistry &getRegistry()
+{
+    static SettingRegistry registry;
+    return registry;
+}
+}
+
 SettingsTree::SettingsTree() : myTree(SettingMap())
 {
+    updateSlots();
+}
+
+int SettingsTree::registerSetting(const std::string &key)
+{
+    SettingRegistry &registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.myMutex);
+
+    auto it = registry.mySlots.find(key);
+    if (it != registry.mySlots.end())
+        return it->second;
+
+    const int slot = static_cast<int>(registry.myKeys.size());
+    registry.myKeys.push_back(key);
+    registry.mySlots.emplace(key, slot);
+    return slot;
+}
+
+void SettingsTree::updateSlots()
+{
+    SettingRegistry &registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.myMutex);
+
+    // Modifying one key can also affect other keys (e.g. replacing a parent
+    // node), so every slot is looked up again. The tree is rarely modified
+    // compared to how often it is read.
+    mySlots.resize(registry.myKeys.size());
+    for (size_t i = 0; i < registry.myKeys.size(); ++i)
+        mySlots[i] = find(registry.myKeys[i]);
 }
 
 void SettingsTree::setImpl(const std::string &key, const SettingValue &value)
 {
     Inserter inserter(key, value);
     boost::apply_visitor(inserter, myTree);
+    updateSlots();
 }
 
 boost::optional<SettingValue> SettingsTree::find(
@@ -262,7 +310,8 @@ boost::optional<SettingValue> SettingsTree::find(
 void SettingsTree::remove(const std::string &key)
 {
     Remover visitor(key);
-    return boost::apply_visitor(visitor, myTree);
+    boost::apply_visitor(visitor, myTree);
+    updateSlots();
 }
 
 void SettingsTree::loadFromJSON(std::istream &is)
@@ -281,6 +330,7 @@ void SettingsTree::loadFromJSON(std::istream &is)
     }
 
     parseValue(myTree, document);
+    updateSlots();
 }
 
 void SettingsTree::saveToJSON(std::ostream &os) const
@@ -29,17 +29,7 @@
 #include <vector>
 
 template <typename T>
-class Setting
-{
-public:
-    Setting(std::string key, T default_value)
-        : myKey(std::move(key)), myDefaultValue(std::move(default_value))
-    {
-    }
-
-    const std::string myKey;
-    const T myDefaultValue;
-};
+class Setting;
 
 class SettingsTree
 {
@@ -66,17 +56,13 @@ public:
     template <typename T>
     std::vector<T> getList(const std::string &key) const;
 
+    /// Retrieve the value of a setting. The setting's key has already been
+    /// resolved to a slot, so this does not need to search the tree.
     template <typename T>
-    T get(const Setting<T> &setting) const
-    {
-        return get<T>(setting.myKey, setting.myDefaultValue);
-    }
+    T get(const Setting<T> &setting) const;
 
     template <typename T>
-    std::vector<T> get(const Setting<std::vector<T>> &setting) const
-    {
-        return getList<T>(setting.myKey);
-    }
+    std::vector<T> get(const Setting<std::vector<T>> &setting) const;
 
     /// Set the value associated with the key.
     template <typename T>
@@ -117,11 +103,48 @@ public:
     void saveToPlist() const;
     void loadFromPlist();
 
+    /// Returns the slot index for the key, registering it if necessary. This
+    /// is done once by each Setting when it is constructed.
+    static int registerSetting(const std::string &key);
+
 private:
     void setImpl(const std::string &key, const SettingValue &value);
     boost::optional<SettingValue> find(const std::string &key) const;
+    /// Returns the value in the setting's slot, or nothing if the setting
+    /// hasn't been set. The slot must be valid.
+    const boost::optional<SettingValue> &findSlot(int slot) const
+    {
+        return mySlots[slot];
+    }
+    /// Looks up the value of each registered setting after the tree has been
+    /// modified.
+    void updateSlots();
+
+    template <typename T>
+    static std::vector<T> convertList(const SettingValue &value);
 
     SettingValue myTree;
+    /// The current value of each registered setting, indexed by slot.
+    std::vector<boost::optional<SettingValue>> mySlots;
+};
+
+/// Describes a setting's key and default value. The key is resolved to a slot
+/// when the setting is created, so reading the setting from a SettingsTree is
+/// a constant-time lookup.
+template <typename T>
+class Setting
+{
+public:
+    Setting(std::string key, T default_value)
+        : myKey(std::move(key)),
+          myDefaultValue(std::move(default_value)),
+          mySlot(SettingsTree::registerSetting(myKey))
+    {
+    }
+
+    const std::string myKey;
+    const T myDefaultValue;
+    const int mySlot;
 };
 
 /// Specialize to support custom types as setting values.
@@ -149,7 +172,14 @@ T SettingsTree::get(const std::string &key, const T &default_val) const
 template <typename T>
 std::vector<T> SettingsTree::getList(const std::string &key) const
 {
-    auto values = get<std::vector<SettingValue>>(key);
+    boost::optional<SettingValue> val = find(key);
+    return val ? convertList<T>(*val) : std::vector<T>();
+}
+
+template <typename T>
+std::vector<T> SettingsTree::convertList(const SettingValue &value)
+{
+    auto &&values = boost::get<std::vector<SettingValue>>(value);
 
     std::vector<T> ts;
     ts.reserve(values.size());
@@ -159,6 +189,28 @@ std::vector<T> SettingsTree::getList(const std::string &key) const
     return ts;
 }
 
+template <typename T>
+T SettingsTree::get(const Setting<T> &setting) const
+{
+    // Settings that were registered after this tree was last updated fall back
+    // to searching the tree.
+    if (setting.mySlot >= static_cast<int>(mySlots.size()))
+        return get<T>(setting.myKey, setting.myDefaultValue);
+
+    const boost::optional<SettingValue> &val = findSlot(setting.mySlot);
+    return val ? SettingValueConverter<T>::from(*val) : setting.myDefaultValue;
+}
+
+template <typename T>
+std::vector<T> SettingsTree::get(const Setting<std::vector<T>> &setting) const
+{
+    if (setting.mySlot >= static_cast<int>(mySlots.size()))
+        return getList<T>(setting.myKey);
+
+    const boost::optional<SettingValue> &val = findSlot(setting.mySlot);
+    return val ? convertList<T>(*val) : std::vector<T>();
+}
+
 template <typename T>
 void SettingsTree::set(const std::string &key, const T &val)
 {
@@ -0,0 +1,250 @@
+/*
+  * Copyright (C) 2016 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef UTIL_SMALLVECTOR_H
+#define UTIL_SMALLVECTOR_H
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/// A vector that stores up to N elements inline, and only allocates memory
+/// when it grows beyond that. This supports the subset of the std::vector
+/// interface that is used by the score classes.
+template <typename T, size_t N>
+class SmallVector
+{
+public:
+    typedef T value_type;
+    typedef T &reference;
+    typedef const T &const_reference;
+    typedef T *pointer;
+    typedef const T *const_pointer;
+    typedef T *iterator;
+    typedef const T *const_iterator;
+    typedef size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    SmallVector() : myData(getInlineData()), mySize(0), myCapacity(N)
+    {
+    }
+
+    SmallVector(const SmallVector &other) : SmallVector()
+    {
+        reserve(other.mySize);
+        std::uninitialized_copy(other.begin(), other.end(), myData);
+        mySize = other.mySize;
+    }
+
+    SmallVector(SmallVector &&other) noexcept(
+        std::is_nothrow_move_constructible<T>::value)
+        : SmallVector()
+    {
+        moveFrom(other);
+    }
+
+    ~SmallVector()
+    {
+        clear();
+        if (!isInline())
+            ::operator delete(myData);
+    }
+
+    SmallVector &operator=(const SmallVector &other)
+    {
+        if (this != &other)
+        {
+            clear();
+            reserve(other.mySize);
+            std::uninitialized_copy(other.begin(), other.end(), myData);
+            mySize = other.mySize;
+        }
+
+        return *this;
+    }
+
+    SmallVector &operator=(SmallVector &&other) noexcept(
+        std::is_nothrow_move_constructible<T>::value)
+    {
+        if (this != &other)
+        {
+            clear();
+            moveFrom(other);
+        }
+
+        return *this;
+    }
+
+    bool operator==(const SmallVector &other) const
+    {
+        return mySize == other.mySize &&
+               std::equal(begin(), end(), other.begin());
+    }
+
+    bool operator!=(const SmallVector &other) const
+    {
+        return !(*this == other);
+    }
+
+    iterator begin() { return myData; }
+    const_iterator begin() const { return myData; }
+    iterator end() { return myData + mySize; }
+    const_iterator end() const { return myData + mySize; }
+
+    size_type size() const { return mySize; }
+    size_type capacity() const { return myCapacity; }
+    bool empty() const { return mySize == 0; }
+
+    reference operator[](size_type i) { return myData[i]; }
+    const_reference operator[](size_type i) const { return myData[i]; }
+    reference front() { return myData[0]; }
+    const_reference front() const { return myData[0]; }
+    reference back() { return myData[mySize - 1]; }
+    const_reference back() const { return myData[mySize - 1]; }
+
+    /// Returns whether the elements are stored inline, without a separate
+    /// heap allocation.
+    bool isInline() const
+    {
+        return myData == getInlineData();
+    }
+
+    void reserve(size_type capacity)
+    {
+        if (capacity <= myCapacity)
+            return;
+
+        T *data = static_cast<T *>(::operator new(capacity * sizeof(T)));
+        std::uninitialized_copy(std::make_move_iterator(begin()),
+                                std::make_move_iterator(end()), data);
+        destroy(begin(), end());
+
+        if (!isInline())
+            ::operator delete(myData);
+
+        myData = data;
+        myCapacity = capacity;
+    }
+
+    void push_back(const T &value)
+    {
+        // Copy first, in case the value refers to an element of this vector.
+        T copy(value);
+        push_back(std::move(copy));
+    }
+
+    void push_back(T &&value)
+    {
+        if (mySize == myCapacity)
+            reserve(myCapacity * 2);
+
+        new (myData + mySize) T(std::move(value));
+        ++mySize;
+    }
+
+    iterator erase(const_iterator first, const_iterator last)
+    {
+        iterator dest = begin() + (first - begin());
+        iterator src = begin() + (last - begin());
+
+        iterator newEnd = std::move(src, end(), dest);
+        destroy(newEnd, end());
+        mySize = newEnd - begin();
+
+        return dest;
+    }
+
+    iterator erase(const_iterator pos)
+    {
+        return erase(pos, pos + 1);
+    }
+
+    void resize(size_type size)
+    {
+        if (size < mySize)
+            destroy(begin() + size, end());
+        else
+        {
+            reserve(size);
+            for (size_type i = mySize; i < size; ++i)
+                new (myData + i) T();
+        }
+
+        mySize = size;
+    }
+
+    void clear()
+    {
+        destroy(begin(), end());
+        mySize = 0;
+    }
+
+private:
+    T *getInlineData()
+    {
+        return reinterpret_cast<T *>(&myStorage);
+    }
+
+    const T *getInlineData() const
+    {
+        return reinterpret_cast<const T *>(&myStorage);
+    }
+
+    static void destroy(iterator first, iterator last)
+    {
+        for (; first != last; ++first)
+            first->~T();
+    }
+
+    /// Takes the elements from another (empty or not) vector. This vector
+    /// must be empty.
+    void moveFrom(SmallVector &other)
+    {
+        if (other.isInline())
+        {
+            std::uninitialized_copy(std::make_move_iterator(other.begin()),
+                                    std::make_move_iterator(other.end()),
+                                    myData);
+            mySize = other.mySize;
+            other.clear();
+        }
+        else
+        {
+            if (!isInline())
+                ::operator delete(myData);
+
+            // Steal the other vector's heap storage.
+            myData = other.myData;
+            mySize = other.mySize;
+            myCapacity = other.myCapacity;
+
+            other.myData = other.getInlineData();
+            other.mySize = 0;
+            other.myCapacity = N;
+        }
+    }
+
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type myStorage[N];
+    T *myData;
+    size_type mySize;
+    size_type myCapacity;
+};
+
+#endif
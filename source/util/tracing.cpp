@@ -0,0 +1,177 @@
+/*
+  * Copyright (C) 2016 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tracing.h"
+
+#include <chrono>
+#include <mutex>
+#include <rapidjson/writer.h>
+#include <util/rapidjson_iostreams.h>
+#include <vector>
+
+namespace
+{
+typedef std::chrono::steady_clock Clock;
+
+struct Event
+{
+    const char *myCategory;
+    const char *myName;
+    /// 'X' for a span, or 'C' for a counter.
+    char myPhase;
+    int myThread;
+    int64_t myTime;
+    /// The duration of a span, or the value of a counter.
+    int64_t myValue;
+};
+
+struct TraceState
+{
+    TraceState() : myStartTime(0)
+    {
+    }
+
+    std::mutex myMutex;
+    /// The time when tracing was enabled, in clock ticks. This is read
+    /// without the lock, since spans can be recorded from any thread.
+    std::atomic<Clock::rep> myStartTime;
+    std::vector<Event> myEvents;
+};
+
+TraceState &getState()
+{
+    static TraceState state;
+    return state;
+}
+
+/// Returns a small, stable id for the current thread.
+int getThreadId()
+{
+    static std::atomic<int> theNextId(1);
+    thread_local int theId = theNextId++;
+    return theId;
+}
+
+void addEvent(const Event &event)
+{
+    TraceState &state = getState();
+    std::lock_guard<std::mutex> lock(state.myMutex);
+    state.myEvents.push_back(event);
+}
+}
+
+namespace Util
+{
+namespace Tracing
+{
+std::atomic<bool> Detail::theIsEnabled(false);
+
+void enable()
+{
+    TraceState &state = getState();
+    {
+        std::lock_guard<std::mutex> lock(state.myMutex);
+        state.myStartTime.store(Clock::now().time_since_epoch().count(),
+                                std::memory_order_relaxed);
+        state.myEvents.clear();
+    }
+
+    Detail::theIsEnabled.store(true, std::memory_order_release);
+}
+
+void disable()
+{
+    Detail::theIsEnabled = false;
+}
+
+int64_t now()
+{
+    const Clock::time_point start(Clock::duration(
+        getState().myStartTime.load(std::memory_order_relaxed)));
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               Clock::now() - start).count();
+}
+
+void recordSpan(const char *category, const char *name, int64_t start,
+                int64_t duration)
+{
+    if (!isEnabled())
+        return;
+
+    addEvent({ category, name, 'X', getThreadId(), start, duration });
+}
+
+void recordCounter(const char *name, int64_t value)
+{
+    if (!isEnabled())
+        return;
+
+    addEvent({ "counter", name, 'C', getThreadId(), now(), value });
+}
+
+void save(std::ostream &os)
+{
+    TraceState &state = getState();
+    std::lock_guard<std::mutex> lock(state.myMutex);
+
+    Util::RapidJSON::OStreamWrapper stream(os);
+    rapidjson::Writer<Util::RapidJSON::OStreamWrapper> writer(stream);
+
+    writer.StartObject();
+    writer.Key("displayTimeUnit");
+    writer.String("ms");
+    writer.Key("traceEvents");
+    writer.StartArray();
+
+    for (const Event &event : state.myEvents)
+    {
+        writer.StartObject();
+        writer.Key("name");
+        writer.String(event.myName);
+        writer.Key("cat");
+        writer.String(event.myCategory);
+        writer.Key("ph");
+        writer.String(&event.myPhase, 1);
+        writer.Key("ts");
+        writer.Int64(event.myTime);
+        writer.Key("pid");
+        writer.Int(1);
+        writer.Key("tid");
+        writer.Int(event.myThread);
+
+        if (event.myPhase == 'X')
+        {
+            writer.Key("dur");
+            writer.Int64(event.myValue);
+        }
+        else
+        {
+            writer.Key("args");
+            writer.StartObject();
+            writer.Key("value");
+            writer.Int64(event.myValue);
+            writer.EndObject();
+        }
+
+        writer.EndObject();
+    }
+
+    writer.EndArray();
+    writer.EndObject();
+}
+}
+}
@@ -0,0 +1,91 @@
+/*
+  * Copyright (C) 2016 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef UTIL_TRACING_H
+#define UTIL_TRACING_H
+
+#include <atomic>
+#include <cstdint>
+#include <iosfwd>
+
+namespace Util
+{
+/// Records spans and counters in the Chrome trace event format, which can be
+/// viewed in chrome://tracing or Perfetto. Nothing is recorded unless tracing
+/// is enabled, so the spans can be left in performance-sensitive code.
+namespace Tracing
+{
+    namespace Detail
+    {
+        extern std::atomic<bool> theIsEnabled;
+    }
+
+    /// Starts recording events, and discards any previously recorded events.
+    void enable();
+    /// Stops recording events.
+    void disable();
+
+    /// If this returns true, the start time set by enable() is visible to
+    /// the calling thread.
+    inline bool isEnabled()
+    {
+        return Detail::theIsEnabled.load(std::memory_order_acquire);
+    }
+
+    /// Returns the current time, in microseconds since tracing was enabled.
+    int64_t now();
+
+    /// Records a span that started at the given time. The names must be string
+    /// literals, since they are not copied.
+    void recordSpan(const char *category, const char *name, int64_t start,
+                    int64_t duration);
+
+    /// Records the current value of a counter.
+    void recordCounter(const char *name, int64_t value);
+
+    /// Writes the recorded events in the Chrome trace JSON format.
+    void save(std::ostream &os);
+
+    /// Records the time spent in a scope.
+    class Span
+    {
+    public:
+        Span(const char *category, const char *name)
+            : myCategory(category),
+              myName(name),
+              myStart(isEnabled() ? now() : -1)
+        {
+        }
+
+        ~Span()
+        {
+            if (myStart >= 0)
+                recordSpan(myCategory, myName, myStart, now() - myStart);
+        }
+
+        Span(const Span &) = delete;
+        Span &operator=(const Span &) = delete;
+
+    private:
+        const char *myCategory;
+        const char *myName;
+        const int64_t myStart;
+    };
+}
+}
+
+#endif
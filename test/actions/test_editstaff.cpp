@@ -21,6 +21,7 @@
 #include <app/appinfo.h>
 #include <formats/powertab/powertabimporter.h>
 #include <score/score.h>
+#include <score/viewfilter.h>
 
 TEST_CASE("Actions/EditStaff", "")
 {
@@ -52,3 +53,34 @@ TEST_CASE("Actions/EditStaff", "")
     REQUIRE(system.getPlayerChanges()[1].getActivePlayers(0).size() == 1);
     REQUIRE(next_system.getPlayerChanges().empty());
 }
+
+TEST_CASE("Actions/EditStaff/ViewFilters", "")
+{
+    Score score;
+    Player player;
+    player.setDescription("Player 1");
+    score.insertPlayer(player);
+
+    ViewFilter filter;
+    filter.addRule(FilterRule(FilterRule::PLAYER_NAME, "Player 2"));
+    score.insertViewFilter(filter);
+
+    System system;
+    system.insertStaff(Staff(6));
+    PlayerChange change;
+    change.insertActivePlayer(0, ActivePlayer(0, 0));
+    system.insertPlayerChange(change);
+    score.insertSystem(system);
+
+    REQUIRE(!score.isStaffVisible(0, 0, 0));
+
+    // Changing the number of strings removes the players from the staff, so
+    // the empty staff should now be visible.
+    ScoreLocation location(score, 0, 0);
+    EditStaff action(location, Staff::TrebleClef, 7);
+    action.redo();
+    REQUIRE(score.isStaffVisible(0, 0, 0));
+
+    action.undo();
+    REQUIRE(!score.isStaffVisible(0, 0, 0));
+}
@@ -0,0 +1,197 @@
+/*
+  * Copyright (C) 2016 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch.hpp>
+
+#include <actions/undomanager.h>
+#include <QUndoCommand>
+#include <score/system.h>
+
+namespace
+{
+class IncrementCommand : public QUndoCommand
+{
+public:
+    IncrementCommand(int &value) : myValue(value)
+    {
+    }
+
+    void redo() override
+    {
+        ++myValue;
+    }
+
+    void undo() override
+    {
+        --myValue;
+    }
+
+private:
+    int &myValue;
+};
+
+/// Keeps a copy of a system, like commands that restore a snapshot on undo.
+class SnapshotCommand : public QUndoCommand, public UndoMemoryCost
+{
+public:
+    SnapshotCommand(const System &system) : mySystem(system)
+    {
+    }
+
+    void getMemoryBlocks(
+        std::vector<SystemUtils::MemoryBlock> &blocks) const override
+    {
+        SystemUtils::getMemoryBlocks(mySystem, blocks);
+    }
+
+private:
+    const System mySystem;
+};
+}
+
+TEST_CASE("Actions/UndoManager/Push", "")
+{
+    UndoManager manager;
+    manager.addNewUndoStack();
+    manager.setActiveStackIndex(0);
+
+    int value = 0;
+    int redraws = 0;
+    QObject::connect(&manager, &UndoManager::redrawNeeded,
+                     [&](int) { ++redraws; });
+
+    manager.push(new IncrementCommand(value), 0);
+    manager.push(new IncrementCommand(value), 0);
+    REQUIRE(value == 2);
+    REQUIRE(redraws == 2);
+
+    manager.undo();
+    REQUIRE(value == 1);
+    REQUIRE(redraws == 3);
+
+    manager.redo();
+    REQUIRE(value == 2);
+    REQUIRE(redraws == 4);
+}
+
+TEST_CASE("Actions/UndoManager/Macro", "")
+{
+    UndoManager manager;
+    manager.addNewUndoStack();
+    manager.setActiveStackIndex(0);
+
+    int value = 0;
+    manager.beginMacro("Macro");
+    manager.push(new IncrementCommand(value), 0);
+    manager.push(new IncrementCommand(value), 0);
+    REQUIRE(value == 2);
+    manager.endMacro();
+
+    REQUIRE(value == 2);
+    REQUIRE(manager.activeStack()->count() == 1);
+
+    manager.undo();
+    REQUIRE(value == 0);
+    manager.redo();
+    REQUIRE(value == 2);
+}
+
+TEST_CASE("Actions/UndoManager/MemoryLimit", "")
+{
+    UndoManager manager;
+    manager.addNewUndoStack();
+    manager.setActiveStackIndex(0);
+    manager.setMemoryLimit(3 * UndoManager::DEFAULT_COMMAND_COST);
+
+    int value = 0;
+    for (int i = 0; i < 5; ++i)
+        manager.push(new IncrementCommand(value), 0);
+
+    // The two oldest commands should have been discarded.
+    REQUIRE(value == 5);
+    REQUIRE(manager.activeStack()->count() == 3);
+    REQUIRE(manager.getMemoryUsage() == 3 * UndoManager::DEFAULT_COMMAND_COST);
+
+    while (manager.canUndo())
+        manager.undo();
+
+    REQUIRE(value == 2);
+}
+
+TEST_CASE("Actions/UndoManager/MemoryLimit/CleanState", "")
+{
+    UndoManager manager;
+    manager.addNewUndoStack();
+    manager.setActiveStackIndex(0);
+    manager.setMemoryLimit(3 * UndoManager::DEFAULT_COMMAND_COST);
+
+    int value = 0;
+    for (int i = 0; i < 2; ++i)
+        manager.push(new IncrementCommand(value), 0);
+    manager.setClean();
+
+    // The saved state should still be reachable after compacting the stack.
+    for (int i = 0; i < 3; ++i)
+        manager.push(new IncrementCommand(value), 0);
+    REQUIRE(manager.activeStack()->count() == 3);
+    REQUIRE(!manager.activeStack()->isClean());
+
+    while (manager.canUndo())
+        manager.undo();
+    REQUIRE(value == 2);
+    REQUIRE(manager.activeStack()->isClean());
+
+    // If the saved state is discarded, the stack can no longer be clean.
+    manager.setClean();
+    for (int i = 0; i < 4; ++i)
+        manager.push(new IncrementCommand(value), 0);
+    REQUIRE(!manager.activeStack()->isClean());
+
+    while (manager.canUndo())
+        manager.undo();
+    REQUIRE(!manager.activeStack()->isClean());
+}
+
+TEST_CASE("Actions/UndoManager/MemoryLimit/SharedSnapshots", "")
+{
+    UndoManager manager;
+    manager.addNewUndoStack();
+    manager.setActiveStackIndex(0);
+
+    System system;
+    system.insertStaff(Staff(6));
+    for (int i = 0; i < 100; ++i)
+        system.getStaves()[0].getVoices()[0].insertPosition(Position(i));
+
+    std::vector<SystemUtils::MemoryBlock> blocks;
+    SystemUtils::getMemoryBlocks(system, blocks);
+    size_t size = 0;
+    for (const SystemUtils::MemoryBlock &block : blocks)
+        size += block.mySize;
+
+    // The snapshots share their contents, which should only be counted once.
+    manager.push(new SnapshotCommand(system), 0);
+    manager.push(new SnapshotCommand(system), 0);
+    REQUIRE(manager.getMemoryUsage() ==
+            2 * UndoManager::DEFAULT_COMMAND_COST + size + sizeof(System));
+
+    int value = 0;
+    manager.undo();
+    manager.undo();
+    manager.push(new IncrementCommand(value), 0);
+    REQUIRE(manager.getMemoryUsage() == UndoManager::DEFAULT_COMMAND_COST);
+}
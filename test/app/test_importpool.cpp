@@ -0,0 +1,67 @@
+/*
+  * Copyright (C) 2016 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch.hpp>
+
+#include <app/appinfo.h>
+#include <app/documentmanager.h>
+#include <app/importpool.h>
+#include <app/settingsmanager.h>
+#include <chrono>
+#include <formats/fileformatmanager.h>
+#include <formats/powertab/common.h>
+#include <thread>
+
+TEST_CASE("App/ImportPool", "")
+{
+    SettingsManager settings;
+    FileFormatManager manager(settings);
+    ImportPool pool(manager);
+
+    // The second file is not in the .pt2 format, so it fails to import.
+    const std::string file1 =
+        AppInfo::getAbsolutePath("data/test_editstaff.pt2");
+    const std::string file2 = AppInfo::getAbsolutePath("data/song_header.ptb");
+    pool.import(file1, getPowerTabFileFormat());
+    pool.import(file2, getPowerTabFileFormat());
+    REQUIRE(pool.isPending(file1));
+
+    // Wait for both imports to finish.
+    std::vector<ImportPool::Result> results;
+    for (int i = 0; i < 1000 && results.size() < 2; ++i)
+    {
+        for (ImportPool::Result &result : pool.takeResults())
+            results.push_back(std::move(result));
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    // The results are returned in the order that they were requested.
+    REQUIRE(results.size() == 2);
+    REQUIRE(results[0].myFilename == file1);
+    REQUIRE(results[0].myDocument);
+    REQUIRE(!results[0].myDocument->getScore().getSystems().empty());
+    REQUIRE(results[1].myFilename == file2);
+    REQUIRE(!results[1].myDocument);
+    REQUIRE(!results[1].myError.empty());
+    REQUIRE(!pool.isPending(file1));
+
+    DocumentManager documents;
+    Document &doc = documents.addDocument(std::move(results[0].myDocument));
+    REQUIRE(documents.getCurrentDocumentIndex() == 0);
+    REQUIRE(&documents.getCurrentDocument() == &doc);
+}
@@ -0,0 +1,63 @@
+/*
+  * Copyright (C) 2016 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch.hpp>
+
+#include <app/documentmanager.h>
+#include <app/scorearea.h>
+#include <painters/barlinepainter.h>
+#include <painters/clickablegroup.h>
+#include <QGraphicsScene>
+
+/// Returns whether hit-testing at the center of the item finds the item.
+static bool isHit(const QGraphicsScene &scene, QGraphicsItem *item)
+{
+    const QPointF center = item->sceneBoundingRect().center();
+    return scene.items(center).contains(item);
+}
+
+TEST_CASE("App/ScoreArea/ItemsHandleClicks", "")
+{
+    Document doc;
+    System system;
+    system.insertStaff(Staff(6));
+    doc.getScore().insertSystem(system);
+
+    ScoreArea area(nullptr);
+    area.renderDocument(doc);
+
+    // The systems are painted from the tile cache, but their items must still
+    // be found by hit-testing.
+    int barlines = 0;
+    int groups = 0;
+    for (QGraphicsItem *item : area.scene()->items())
+    {
+        if (dynamic_cast<BarlinePainter *>(item))
+        {
+            ++barlines;
+            REQUIRE(isHit(*area.scene(), item));
+        }
+        else if (dynamic_cast<ClickableGroup *>(item))
+        {
+            ++groups;
+            REQUIRE(isHit(*area.scene(), item));
+        }
+    }
+
+    REQUIRE(barlines == 2);
+    REQUIRE(groups > 0);
+}
@@ -18,6 +18,7 @@
 #include <catch.hpp>
 
 #include <app/settingsmanager.h>
+#include <atomic>
 
 TEST_CASE("App/SettingsManager", "")
 {
@@ -39,3 +40,38 @@ TEST_CASE("App/SettingsManager", "")
 
     REQUIRE(count == 1);
 }
+
+TEST_CASE("App/SettingsManager/Snapshot", "")
+{
+    SettingsManager manager;
+    SettingsManager::Snapshot initial = manager.getSnapshot();
+    REQUIRE(initial);
+    REQUIRE(manager.getSnapshotVersion() == 0);
+
+    {
+        auto settings = manager.getWriteHandle();
+        settings->set("foo", 42);
+    }
+
+    REQUIRE(manager.getSnapshotVersion() == 1);
+
+    SettingsManager::Snapshot snapshot = manager.getSnapshot();
+    REQUIRE(snapshot->get<int>("foo") == 42);
+
+    // Existing snapshots are not modified.
+    REQUIRE(initial->get<int>("foo", 0) == 0);
+
+    {
+        auto settings = manager.getWriteHandle();
+        settings->set("foo", 43);
+    }
+
+    REQUIRE(snapshot->get<int>("foo") == 42);
+    REQUIRE(manager.getSnapshot()->get<int>("foo") == 43);
+
+    snapshot = manager.getSnapshot();
+    REQUIRE(snapshot->get<int>("foo") == 43);
+
+    // Reading a snapshot must not take a lock.
+    REQUIRE(ATOMIC_POINTER_LOCK_FREE == 2);
+}
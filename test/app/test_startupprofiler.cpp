@@ -0,0 +1,43 @@
+/*
+  * Copyright (C) 2016 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+  
+#include <catch.hpp>
+
+#include <app/startupprofiler.h>
+#include <sstream>
+
+TEST_CASE("App/StartupProfiler", "")
+{
+    std::ostringstream disabled;
+    StartupProfiler::markPhase("Ignored");
+    StartupProfiler::report(disabled);
+    REQUIRE(disabled.str().empty());
+
+    StartupProfiler::enable();
+    REQUIRE(StartupProfiler::isEnabled());
+    StartupProfiler::markPhase("First phase");
+    StartupProfiler::markPhase("Second phase");
+
+    std::ostringstream output;
+    StartupProfiler::report(output);
+
+    const std::string report = output.str();
+    REQUIRE(report.find("Ignored") == std::string::npos);
+    REQUIRE(report.find("First phase") != std::string::npos);
+    REQUIRE(report.find("Second phase") != std::string::npos);
+    REQUIRE(report.find("Total") != std::string::npos);
+}
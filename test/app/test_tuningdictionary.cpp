@@ -0,0 +1,66 @@
+/*
+  * Copyright (C) 2016 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch.hpp>
+
+#include <app/tuningdictionary.h>
+#include <sstream>
+
+TEST_CASE("App/TuningDictionary/Cache", "")
+{
+    std::vector<Tuning> tunings(2);
+    tunings[0].setName("Standard");
+    tunings[1].setName("Open G");
+    tunings[1].setNotes({ 62, 59, 55, 50, 43, 38 });
+    tunings[1].setCapo(3);
+    tunings[1].setSharps(false);
+    tunings[1].setMusicNotationOffset(-1);
+
+    TuningDictionary::SourceInfo source;
+    source.myPath = "data/tunings.json";
+    source.mySize = 1024;
+    source.myModifiedTime = 1234567;
+
+    std::ostringstream output;
+    TuningDictionary::saveCache(output, source, tunings);
+    const std::string data = output.str();
+
+    {
+        std::istringstream input(data);
+        std::vector<Tuning> loaded;
+        REQUIRE(TuningDictionary::loadCache(input, source, loaded));
+        REQUIRE(loaded == tunings);
+    }
+
+    // The cache is out of date if the source file was modified.
+    {
+        TuningDictionary::SourceInfo modified = source;
+        modified.myModifiedTime++;
+
+        std::istringstream input(data);
+        std::vector<Tuning> loaded;
+        REQUIRE(!TuningDictionary::loadCache(input, modified, loaded));
+        REQUIRE(loaded.empty());
+    }
+
+    // Truncated files are rejected.
+    {
+        std::istringstream input(data.substr(0, data.size() - 2));
+        std::vector<Tuning> loaded;
+        REQUIRE(!TuningDictionary::loadCache(input, source, loaded));
+    }
+}
@@ -0,0 +1,130 @@
+/*
+  * Copyright (C) 2016 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch.hpp>
+
+#include <midi/timemap.h>
+#include <score/score.h>
+
+/// Creates a system with four quarter notes in the first bar, and two half
+/// notes in the second bar.
+static System createSystem()
+{
+    System system;
+    system.insertBarline(Barline(8, Barline::SingleBar));
+
+    Staff staff(6);
+    Voice &voice = staff.getVoices()[0];
+    for (int i = 0; i < 4; ++i)
+        voice.insertPosition(Position(i * 2, Position::QuarterNote));
+    voice.insertPosition(Position(9, Position::HalfNote));
+    voice.insertPosition(Position(11, Position::HalfNote));
+
+    system.insertStaff(staff);
+    return system;
+}
+
+TEST_CASE("Midi/TimeMap/GetTime", "")
+{
+    Score score;
+    score.insertSystem(createSystem());
+    score.insertSystem(createSystem());
+
+    TimeMap timeMap;
+    timeMap.update(score);
+
+    // At the default tempo of 120 bpm, each bar lasts for two seconds.
+    REQUIRE(timeMap.getDuration() == Approx(8));
+    REQUIRE(*timeMap.getTime(SystemLocation(0, 0)) == Approx(0));
+    REQUIRE(*timeMap.getTime(SystemLocation(0, 2)) == Approx(0.5));
+    REQUIRE(*timeMap.getTime(SystemLocation(0, 9)) == Approx(2));
+    REQUIRE(*timeMap.getTime(SystemLocation(0, 11)) == Approx(3));
+    REQUIRE(*timeMap.getTime(SystemLocation(1, 6)) == Approx(5.5));
+
+    // Locations outside the score are never played.
+    REQUIRE(!timeMap.getTime(SystemLocation(2, 0)));
+}
+
+TEST_CASE("Midi/TimeMap/GetLocation", "")
+{
+    Score score;
+    score.insertSystem(createSystem());
+    score.insertSystem(createSystem());
+
+    TimeMap timeMap;
+    timeMap.update(score);
+
+    REQUIRE(timeMap.getLocation(0) == SystemLocation(0, 0));
+    REQUIRE(timeMap.getLocation(0.75) == SystemLocation(0, 2));
+    REQUIRE(timeMap.getLocation(3.5) == SystemLocation(0, 11));
+    REQUIRE(timeMap.getLocation(4) == SystemLocation(1, 0));
+
+    for (int position : { 0, 2, 4, 6, 9, 11 })
+    {
+        const SystemLocation location(1, position);
+        REQUIRE(timeMap.getLocation(*timeMap.getTime(location)) == location);
+    }
+}
+
+TEST_CASE("Midi/TimeMap/TempoChange", "")
+{
+    Score score;
+    score.insertSystem(createSystem());
+    score.insertSystem(createSystem());
+
+    TimeMap timeMap;
+    timeMap.update(score);
+    REQUIRE(*timeMap.getTime(SystemLocation(1, 0)) == Approx(4));
+
+    // Slow down to 60 bpm for the second bar.
+    TempoMarker marker(8);
+    marker.setBeatType(TempoMarker::Quarter);
+    marker.setBeatsPerMinute(60);
+    score.getSystems()[0].insertTempoMarker(marker);
+
+    // The map is not updated until the system is invalidated.
+    timeMap.update(score);
+    REQUIRE(*timeMap.getTime(SystemLocation(1, 0)) == Approx(4));
+
+    timeMap.invalidateSystem(0);
+    timeMap.update(score);
+    REQUIRE(*timeMap.getTime(SystemLocation(0, 9)) == Approx(2));
+    REQUIRE(*timeMap.getTime(SystemLocation(0, 11)) == Approx(4));
+
+    // The new tempo remains in effect for the next system.
+    REQUIRE(*timeMap.getTime(SystemLocation(1, 0)) == Approx(6));
+    REQUIRE(*timeMap.getTime(SystemLocation(1, 2)) == Approx(7));
+    REQUIRE(timeMap.getDuration() == Approx(14));
+}
+
+TEST_CASE("Midi/TimeMap/Repeats", "")
+{
+    Score score;
+    System system = createSystem();
+    system.getBarlines()[0].setBarType(Barline::RepeatStart);
+    system.getBarlines()[1].setBarType(Barline::RepeatEnd);
+    system.getBarlines()[1].setRepeatCount(2);
+    score.insertSystem(system);
+
+    TimeMap timeMap;
+    timeMap.update(score);
+
+    // The first bar is played twice.
+    REQUIRE(timeMap.getDuration() == Approx(6));
+    REQUIRE(*timeMap.getTime(SystemLocation(0, 9)) == Approx(4));
+    REQUIRE(timeMap.getLocation(2.5) == SystemLocation(0, 2));
+}
@@ -0,0 +1,103 @@
+/*
+  * Copyright (C) 2016 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch.hpp>
+
+#include <painters/layoutinfo.h>
+#include <painters/spatialindex.h>
+#include <score/score.h>
+
+TEST_CASE("Painters/SpatialIndex/Find", "")
+{
+    Score score;
+    System system;
+    Staff staff1(6);
+    staff1.getVoices()[0].insertPosition(Position(0));
+    staff1.getVoices()[0].insertPosition(Position(5));
+    system.insertStaff(staff1);
+    system.insertStaff(Staff(7));
+    score.insertSystem(system);
+    score.insertSystem(system);
+
+    const System &sys = score.getSystems()[0];
+    const LayoutInfo layout1(score, sys, 0, sys.getStaves()[0], 0);
+    const LayoutInfo layout2(score, sys, 0, sys.getStaves()[1], 1);
+
+    const double top1 = layout1.getSystemSymbolSpacing();
+    const double top2 = top1 + layout1.getStaffHeight();
+    const double height = top2 + layout2.getStaffHeight();
+    const std::vector<SpatialIndex::StaffEntry> staves = {
+        SpatialIndex::StaffEntry(0, top1, layout1),
+        SpatialIndex::StaffEntry(1, top2, layout2)
+    };
+
+    SpatialIndex index;
+    index.reset(2);
+    index.setSystem(0, QRectF(0, 0, LayoutInfo::STAFF_WIDTH, height), staves,
+                    &layout1);
+    index.setSystem(1, QRectF(0, height + 50, LayoutInfo::STAFF_WIDTH, height),
+                    staves, &layout1);
+
+    // Above the first staff, and in the gap between the systems.
+    REQUIRE(!index.find(QPointF(100, -10)));
+    REQUIRE(!index.find(QPointF(100, height + 25)));
+
+    // The third string of the second staff in the second system.
+    const double y = height + 50 + top2 + layout2.getTabLine(3);
+    const double x = layout1.getPositionX(5) + 1;
+    auto hit = index.find(QPointF(x, y));
+    REQUIRE(hit);
+    REQUIRE(hit->mySystem == 1);
+    REQUIRE(hit->myStaff == 1);
+    REQUIRE(hit->myString == 2);
+    REQUIRE(hit->myPosition == layout1.getPositionFromX(x));
+
+    // Above the tab staff.
+    hit = index.find(QPointF(x, top1 + 1));
+    REQUIRE(hit);
+    REQUIRE(hit->myStaff == 0);
+    REQUIRE(hit->myString == -1);
+
+    REQUIRE(index.getStaffTop(1, 1) == height + 50 + top2);
+
+    // Moving a system updates the lookup.
+    index.setSystemTop(1, height + 100);
+    REQUIRE(!index.find(QPointF(x, height + 75)));
+    REQUIRE(index.getSystemRect(1).top() == height + 100);
+}
+
+TEST_CASE("Painters/SpatialIndex/FindPosition", "")
+{
+    Score score;
+    System system;
+    Staff staff(6);
+    staff.getVoices()[0].insertPosition(Position(10));
+    system.insertStaff(staff);
+    score.insertSystem(system);
+
+    const System &sys = score.getSystems()[0];
+    const LayoutInfo layout(score, sys, 0, sys.getStaves()[0], 0);
+
+    SpatialIndex index;
+    index.reset(1);
+    index.setSystem(0, QRectF(0, 0, LayoutInfo::STAFF_WIDTH, 100),
+                    { SpatialIndex::StaffEntry(0, 0, layout) }, &layout);
+
+    // The results should be identical to the linear search in LayoutInfo.
+    for (double x = 0; x < LayoutInfo::STAFF_WIDTH; x += 3.7)
+        REQUIRE(index.findPosition(0, x) == layout.getPositionFromX(x));
+}
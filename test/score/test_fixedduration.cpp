@@ -0,0 +1,70 @@
+/*
+  * Copyright (C) 2016 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch.hpp>
+
+#include <score/fixedduration.h>
+
+TEST_CASE("Score/FixedDuration/Arithmetic", "")
+{
+    FixedDuration quarter(FixedDuration::TICKS_PER_QUARTER);
+    REQUIRE(quarter.isExact());
+    REQUIRE(quarter.toRational() == 1);
+    REQUIRE(FixedDuration(boost::rational<int>(1, 3)).isExact());
+
+    FixedDuration sum = quarter + FixedDuration(boost::rational<int>(1, 2));
+    REQUIRE(sum.toRational() == boost::rational<int>(3, 2));
+    REQUIRE(sum.toDouble() == Approx(1.5));
+    REQUIRE((sum * 3).toRational() == boost::rational<int>(9, 2));
+
+    REQUIRE(quarter < sum);
+    REQUIRE(sum > quarter);
+    REQUIRE(quarter <= quarter);
+    REQUIRE(FixedDuration() == FixedDuration(0));
+
+    // Convert to the resolution of a MIDI file.
+    REQUIRE(sum.convertTicks(960) == 1440);
+}
+
+TEST_CASE("Score/FixedDuration/Remainder", "")
+{
+    // A seventh of a quarter note isn't a whole number of ticks.
+    const boost::rational<int> seventh(1, 7);
+    FixedDuration duration(seventh);
+    REQUIRE(!duration.isExact());
+    REQUIRE(duration.toRational() == seventh);
+    REQUIRE(duration.getTicks() == FixedDuration::TICKS_PER_QUARTER / 7);
+
+    // Adding the fractions together should give an exact result again.
+    FixedDuration total;
+    for (int i = 0; i < 7; ++i)
+        total += duration;
+
+    REQUIRE(total.isExact());
+    REQUIRE(total == FixedDuration(FixedDuration::TICKS_PER_QUARTER));
+    REQUIRE((duration * 14).toRational() == 2);
+
+    // Durations that differ by less than a tick are still ordered correctly.
+    const FixedDuration a(boost::rational<int>(1, 7));
+    const FixedDuration b(seventh + boost::rational<int>(1, 100000));
+    REQUIRE(a.getTicks() == b.getTicks());
+    REQUIRE(a < b);
+    REQUIRE(!(b < a));
+    REQUIRE(a != b);
+
+    REQUIRE(duration.convertTicks(700) == 100);
+}
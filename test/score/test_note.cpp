@@ -148,3 +148,24 @@ TEST_CASE("Score/Note/Serialization", "")
 
     Serialization::test("note", note);
 }
+
+TEST_CASE("Score/Note/RareProperties", "")
+{
+    Note note(3, 12);
+    note.setTrilledFret(14);
+    note.setBend(
+        Bend(Bend::BendAndHold, 2, 0, 0, Bend::LowPoint, Bend::MidPoint));
+
+    // Modifying a copy does not affect the original note.
+    Note copy(note);
+    copy.clearTrill();
+    REQUIRE(note.hasTrill());
+    REQUIRE(!copy.hasTrill());
+    REQUIRE(copy.hasBend());
+    REQUIRE(!(copy == note));
+
+    // Once all of the properties are cleared, the note is the same as one that
+    // never had them.
+    copy.clearBend();
+    REQUIRE(copy == Note(3, 12));
+}
@@ -18,6 +18,7 @@
 #include <catch.hpp>
 
 #include <score/position.h>
+#include <type_traits>
 #include "test_serialization.h"
 
 TEST_CASE("Score/Position/SimpleProperties", "")
@@ -62,6 +63,9 @@ TEST_CASE("Score/Position/Notes", "")
     position.removeNote(note1);
     REQUIRE(position.getNotes().size() == 1);
     REQUIRE(position.getNotes()[0] == note2);
+    // Positions are stored in a std::vector, which only moves them when
+    // reallocating if moving cannot throw.
+    REQUIRE(std::is_nothrow_move_constructible<Position>::value);
 }
 
 TEST_CASE("Score/Position/FindByString", "")
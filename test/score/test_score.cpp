@@ -32,6 +32,52 @@ TEST_CASE("Score/Score/Systems", "")
     REQUIRE(score.getSystems().size() == 0);
 }
 
+TEST_CASE("Score/Score/ShrinkToFit", "")
+{
+    Score score;
+    Score expected;
+
+    // Build the score by moving the systems and positions in, as the
+    // importers do.
+    for (int i = 0; i < 10; ++i)
+    {
+        System system;
+        System copy;
+        Staff staff(6);
+        Staff staffCopy(6);
+
+        for (int j = 0; j < 20; ++j)
+        {
+            Position pos(j, Position::EighthNote);
+            pos.insertNote(Note(j % 6, j));
+            staffCopy.getVoices()[0].insertPosition(pos);
+            staff.getVoices()[0].insertPosition(std::move(pos));
+        }
+
+        system.insertStaff(std::move(staff));
+        copy.insertStaff(staffCopy);
+        score.insertSystem(std::move(system));
+        expected.insertSystem(copy);
+    }
+
+    score.shrinkToFit();
+    REQUIRE(score == expected);
+
+    for (const System &system : score.getSystems())
+    {
+        REQUIRE(system.getStaffCapacity() == system.getStaves().size());
+
+        for (const Staff &staff : system.getStaves())
+        {
+            for (const Voice &voice : staff.getVoices())
+            {
+                REQUIRE(voice.getPositionCapacity() ==
+                        voice.getPositions().size());
+            }
+        }
+    }
+}
+
 TEST_CASE("Score/Score/Players", "")
 {
     Score score;
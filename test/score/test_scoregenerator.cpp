@@ -0,0 +1,67 @@
+/*
+  * Copyright (C) 2016 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch.hpp>
+
+#include <midi/timemap.h>
+#include <score/score.h>
+#include <score/utils/repeatindexer.h>
+#include <testutil/scoregenerator.h>
+
+TEST_CASE("Score/ScoreGenerator/Deterministic", "")
+{
+    ScoreGenerator::Options options;
+    options.mySystemCount = 20;
+    options.myStaffCount = 3;
+
+    Score score1;
+    Score score2;
+    ScoreGenerator::generate(score1, options);
+    ScoreGenerator::generate(score2, options);
+
+    REQUIRE(score1.getSystems().size() == 20);
+    REQUIRE(score1.getPlayers().size() == 3);
+    REQUIRE(score1.getSystems()[0].getStaves().size() == 3);
+    REQUIRE(score1 == score2);
+
+    Score score3;
+    options.mySeed = 2;
+    ScoreGenerator::generate(score3, options);
+    REQUIRE(!(score1 == score3));
+}
+
+TEST_CASE("Score/ScoreGenerator/Repeats", "")
+{
+    ScoreGenerator::Options options;
+    options.mySystemCount = 12;
+
+    Score score;
+    ScoreGenerator::generate(score, options);
+
+    // Every fourth system is repeated.
+    RepeatIndexer index(score);
+    const RepeatedSection *repeat = index.findRepeat(SystemLocation(4, 10));
+    REQUIRE(repeat);
+    REQUIRE(repeat->getStartBarLocation() == SystemLocation(4, 0));
+    REQUIRE(!index.findRepeat(SystemLocation(1, 10)));
+    REQUIRE(!index.findRepeat(SystemLocation(11, 0)));
+
+    // The first system has four bars at 80 bpm, and is played twice.
+    TimeMap timeMap;
+    timeMap.update(score);
+    REQUIRE(*timeMap.getTime(SystemLocation(1, 0)) == Approx(24));
+}
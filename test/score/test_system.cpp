@@ -203,3 +203,32 @@ TEST_CASE("Score/System/TextItems", "")
     REQUIRE(system.getTextItems().size() == 1);
     REQUIRE(system.getTextItems()[0] == text1);
 }
+
+TEST_CASE("Score/System/CopyOnWrite", "")
+{
+    System system;
+    Staff staff;
+    staff.getVoices()[0].insertPosition(Position(3));
+    system.insertStaff(staff);
+    system.insertStaff(staff);
+    system.insertBarline(Barline(5, Barline::SingleBar));
+
+    // A copy shares its contents with the original.
+    const System copy(system);
+    const System &original = system;
+    REQUIRE(&copy.getStaves()[0] == &original.getStaves()[0]);
+    REQUIRE(&copy.getBarlines()[1] == &original.getBarlines()[1]);
+
+    // Modifying the original does not affect the copy.
+    system.getStaves()[0].getVoices()[0].insertPosition(Position(7));
+    system.removeBarline(Barline(5, Barline::SingleBar));
+    REQUIRE(copy.getStaves()[0].getVoices()[0].getPositions().size() == 1);
+    REQUIRE(copy.getBarlines().size() == 3);
+    REQUIRE(original.getStaves()[0].getVoices()[0].getPositions().size() == 2);
+    REQUIRE(original.getBarlines().size() == 2);
+
+    // The staff that wasn't modified still shares its positions.
+    REQUIRE(&copy.getStaves()[1].getVoices()[0].getPositions()[0] ==
+            &original.getStaves()[1].getVoices()[0].getPositions()[0]);
+    REQUIRE(!(copy == original));
+}
@@ -20,6 +20,7 @@
 #include <score/score.h>
 #include <score/system.h>
 #include <score/utils.h>
+#include <score/utils/scorepolisher.h>
 
 TEST_CASE("Score/Utils/FindByPosition", "")
 {
@@ -47,3 +48,134 @@ TEST_CASE("Score/Utils/GetCurrentPlayers", "")
     REQUIRE(ScoreUtils::getCurrentPlayers(score, 0, 7));
     REQUIRE(ScoreUtils::getCurrentPlayers(score, 1, 0));
 }
+
+/// Creates a score with a player change in every tenth system.
+static void createLargeScore(Score &score, int numSystems)
+{
+    for (int i = 0; i < numSystems; ++i)
+    {
+        System system;
+        system.insertStaff(Staff(6));
+
+        if (i % 10 == 0)
+        {
+            PlayerChange change;
+            change.setPosition(i % 7);
+            change.insertActivePlayer(0, ActivePlayer(i, 0));
+            system.insertPlayerChange(change);
+        }
+
+        score.insertSystem(system);
+    }
+}
+
+/// Finds the current player change by scanning all previous systems.
+static const PlayerChange *findPlayersLinear(const Score &score,
+                                             int systemIndex, int position)
+{
+    const PlayerChange *lastChange = nullptr;
+    for (int i = 0; i <= systemIndex; ++i)
+    {
+        const System &system = score.getSystems()[i];
+        for (const PlayerChange &change : system.getPlayerChanges())
+        {
+            if (i < systemIndex || change.getPosition() <= position)
+                lastChange = &change;
+        }
+    }
+
+    return lastChange;
+}
+
+TEST_CASE("Score/Utils/GetCurrentPlayers/Index", "")
+{
+    Score score;
+    createLargeScore(score, 500);
+
+    for (int i = 0; i < 500; ++i)
+    {
+        for (int position = 0; position < 10; ++position)
+        {
+            REQUIRE(ScoreUtils::getCurrentPlayers(score, i, position) ==
+                    findPlayersLinear(score, i, position));
+        }
+    }
+
+    // Adding a player change to a system must invalidate the index.
+    PlayerChange change;
+    change.setPosition(3);
+    score.getSystems()[255].insertPlayerChange(change);
+    score.invalidatePlayerChanges();
+    REQUIRE(ScoreUtils::getCurrentPlayers(score, 256, 0) ==
+            &score.getSystems()[255].getPlayerChanges().front());
+
+    // Removing a system also updates the index.
+    score.removeSystem(255);
+    REQUIRE(ScoreUtils::getCurrentPlayers(score, 255, 0) ==
+            findPlayersLinear(score, 255, 0));
+}
+
+/// Creates a system with quarter notes that are packed together.
+static System createUnpolishedSystem(int numNotes)
+{
+    System system;
+    Staff staff(6);
+    for (int i = 0; i < numNotes; ++i)
+    {
+        staff.getVoices()[0].insertPosition(
+            Position(i, Position::QuarterNote));
+    }
+
+    system.insertStaff(staff);
+    return system;
+}
+
+TEST_CASE("Score/Utils/PolishSystem/SharedCopy", "")
+{
+    System system = createUnpolishedSystem(4);
+    // The copy shares the staves and positions with the system until one of
+    // them is modified.
+    const System original = system;
+
+    ScoreUtils::polishSystem(system);
+
+    const Voice &voice = system.getStaves()[0].getVoices()[0];
+    REQUIRE(voice.getPositions()[0].getPosition() == 0);
+    REQUIRE(voice.getPositions()[1].getPosition() == 2);
+    REQUIRE(voice.getPositions()[2].getPosition() == 4);
+    REQUIRE(voice.getPositions()[3].getPosition() == 6);
+    REQUIRE(system.getBarlines()[1].getPosition() == 8);
+
+    // The copy is unchanged.
+    REQUIRE(original == createUnpolishedSystem(4));
+}
+
+TEST_CASE("Score/Utils/PolishScore", "")
+{
+    Score score;
+    Score expected;
+    for (int i = 0; i < 50; ++i)
+    {
+        score.insertSystem(createUnpolishedSystem(1 + i % 4));
+
+        System system = createUnpolishedSystem(1 + i % 4);
+        ScoreUtils::polishSystem(system);
+        expected.insertSystem(system);
+    }
+
+    ScoreUtils::polishScore(score);
+
+    // Polishing the systems in parallel gives the same result.
+    REQUIRE(score.getSystems().size() == expected.getSystems().size());
+    for (size_t i = 0; i < score.getSystems().size(); ++i)
+        REQUIRE(score.getSystems()[i] == expected.getSystems()[i]);
+
+    // Quarter notes are spaced two positions apart.
+    const System &system = score.getSystems()[3];
+    const Voice &voice = system.getStaves()[0].getVoices()[0];
+    REQUIRE(voice.getPositions()[0].getPosition() == 0);
+    REQUIRE(voice.getPositions()[1].getPosition() == 2);
+    REQUIRE(voice.getPositions()[2].getPosition() == 4);
+    REQUIRE(voice.getPositions()[3].getPosition() == 6);
+    REQUIRE(system.getBarlines()[1].getPosition() == 8);
+}
@@ -58,6 +58,43 @@ TEST_CASE("Score/ViewFilter/ViewFilter", "")
     REQUIRE(filter.accept(score, 0, 2));
 }
 
+TEST_CASE("Score/ViewFilter/StaffVisibility", "")
+{
+    Score score;
+
+    PowerTabImporter importer;
+    importer.load(AppInfo::getAbsolutePath("data/test_viewfilter.pt2"), score);
+
+    ViewFilter filter;
+    filter.addRule(FilterRule(FilterRule::NUM_STRINGS, FilterRule::EQUAL, 7));
+    score.insertViewFilter(filter);
+    const int filterIndex = score.getViewFilters().size() - 1;
+
+    // The cached results should match the filter.
+    for (int i = 0; i < static_cast<int>(score.getSystems().size()); ++i)
+    {
+        const System &system = score.getSystems()[i];
+        for (int j = 0; j < static_cast<int>(system.getStaves().size()); ++j)
+        {
+            REQUIRE(score.isStaffVisible(filterIndex, i, j) ==
+                    filter.accept(score, i, j));
+        }
+    }
+
+    REQUIRE(!score.isStaffVisible(filterIndex, 0, 0));
+    REQUIRE(score.isStaffVisible(filterIndex, 0, 1));
+
+    // Editing the players must invalidate the results.
+    Tuning tuning;
+    tuning.setNotes({ 64, 59, 55, 50, 45, 40, 35 });
+    for (Player &player : score.getPlayers())
+        player.setTuning(tuning);
+    score.invalidateViewFilters();
+
+    REQUIRE(score.isStaffVisible(filterIndex, 0, 0));
+    REQUIRE(score.isStaffVisible(filterIndex, 0, 1));
+}
+
 TEST_CASE("Score/ViewFilter/Serialization", "")
 {
     ViewFilter filter;
@@ -40,4 +40,64 @@ TEST_CASE("Score/VoiceUtils/GetDurationTime", "")
 
     voice.insertIrregularGrouping(IrregularGrouping(7, 1, 3, 2));
     REQUIRE(VoiceUtils::getDurationTime(voice, position) == 4);
-}
\ No newline at end of file
+}
+
+TEST_CASE("Score/VoiceUtils/GetFixedDurationTime", "")
+{
+    const Position::DurationType durations[] = {
+        Position::WholeNote,        Position::HalfNote,
+        Position::QuarterNote,      Position::EighthNote,
+        Position::SixteenthNote,    Position::ThirtySecondNote,
+        Position::SixtyFourthNote };
+    const std::pair<int, int> groups[] = {
+        { 3, 2 }, { 5, 4 }, { 6, 4 }, { 7, 4 }, { 9, 8 }, { 11, 8 } };
+
+    // The results should match the rational arithmetic, including for
+    // groupings that don't divide evenly into ticks.
+    for (Position::DurationType duration : durations)
+    {
+        for (int dots = 0; dots < 3; ++dots)
+        {
+            for (int group = -1; group < 6; ++group)
+            {
+                Voice voice;
+                Position pos(4, duration);
+                if (dots == 1)
+                    pos.setProperty(Position::Dotted);
+                else if (dots == 2)
+                    pos.setProperty(Position::DoubleDotted);
+                voice.insertPosition(pos);
+
+                if (group >= 0)
+                {
+                    voice.insertIrregularGrouping(IrregularGrouping(
+                        4, 1, groups[group].first, groups[group].second));
+                }
+
+                const Position &position = voice.getPositions().front();
+                const FixedDuration fixed =
+                    VoiceUtils::getFixedDurationTime(voice, position);
+
+                REQUIRE(fixed.toRational() ==
+                        VoiceUtils::getDurationTime(voice, position));
+            }
+        }
+    }
+
+    // Triplets are a whole number of ticks, but septuplets are not.
+    Voice voice;
+    voice.insertPosition(Position(0, Position::EighthNote));
+    voice.insertIrregularGrouping(IrregularGrouping(0, 1, 3, 2));
+    REQUIRE(VoiceUtils::getFixedDurationTime(
+                voice, voice.getPositions().front()).isExact());
+
+    voice.removeIrregularGrouping(voice.getIrregularGroupings().front());
+    voice.insertIrregularGrouping(IrregularGrouping(0, 1, 7, 4));
+    REQUIRE(!VoiceUtils::getFixedDurationTime(
+                 voice, voice.getPositions().front()).isExact());
+
+    // Grace notes have no duration.
+    Position grace(0, Position::EighthNote);
+    grace.setProperty(Position::Acciaccatura);
+    REQUIRE(VoiceUtils::getFixedDurationTime(voice, grace) == FixedDuration());
+}
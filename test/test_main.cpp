@@ -17,13 +17,18 @@
 
 #define CATCH_CONFIG_RUNNER
 #include <catch.hpp>
-#include <QCoreApplication>
+#include <QApplication>
 
 int main(int argc, char *argv[])
 {
-    // Initialize QCoreApplication for any tests that use
+    // Some tests render the score into a QGraphicsScene, which requires a
+    // QApplication. Don't require a display when running the tests.
+    if (qgetenv("QT_QPA_PLATFORM").isEmpty())
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    // This also supports tests that use
     // QCoreApplication::applicationDirPath().
-    QCoreApplication app(argc, argv);
+    QApplication app(argc, argv);
 
     return Catch::Session().run(argc, argv);
 }
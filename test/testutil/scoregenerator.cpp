@@ -0,0 +1,164 @@
+/*
+  * Copyright (C) 2016 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "scoregenerator.h"
+
+#include <random>
+#include <score/score.h>
+#include <string>
+
+namespace
+{
+const int theStringCount = 6;
+/// Each bar contains eight eighth notes in the first voice, and four quarter
+/// notes in the second voice.
+const int theNotesPerBar = 8;
+
+Note createNote(std::minstd_rand &random, int string, int noteIndex)
+{
+    Note note(string, random() % 13);
+
+    if (noteIndex % 16 == 0)
+        note.setBend(Bend(Bend::NormalBend, 4));
+    if (noteIndex % 11 == 0)
+        note.setProperty(Note::HammerOnOrPullOff, true);
+
+    return note;
+}
+
+System createSystem(std::minstd_rand &random, int systemIndex,
+                    const ScoreGenerator::Options &options)
+{
+    System system;
+
+    int position = 0;
+    for (int bar = 0; bar < options.myBarsPerSystem; ++bar)
+    {
+        if (bar > 0)
+        {
+            system.insertBarline(Barline(position, Barline::SingleBar));
+            ++position;
+        }
+
+        position += theNotesPerBar;
+    }
+
+    Barline &endBar = system.getBarlines().back();
+    endBar.setPosition(position);
+
+    // Repeat every fourth system.
+    if (systemIndex % 4 == 0)
+    {
+        system.getBarlines().front().setBarType(Barline::RepeatStart);
+        endBar.setBarType(Barline::RepeatEnd);
+        endBar.setRepeatCount(2);
+    }
+
+    for (int i = 0; i < options.myStaffCount; ++i)
+    {
+        Staff staff(theStringCount);
+        Voice &lead = staff.getVoices()[0];
+        Voice &bass = staff.getVoices()[1];
+
+        int noteIndex = 0;
+        for (int bar = 0; bar < options.myBarsPerSystem; ++bar)
+        {
+            const int start = bar * (theNotesPerBar + 1);
+            for (int j = 0; j < theNotesPerBar; ++j)
+            {
+                Position pos(start + j, Position::EighthNote);
+                pos.insertNote(createNote(random, random() % 3, noteIndex));
+                pos.insertNote(createNote(random, 3 + random() % 3, noteIndex));
+                if (j % 4 == 3)
+                    pos.setProperty(Position::PalmMuting, true);
+                lead.insertPosition(std::move(pos));
+
+                if (j % 2 == 0)
+                {
+                    Position bassPos(start + j, Position::QuarterNote);
+                    bassPos.insertNote(
+                        createNote(random, theStringCount - 1, noteIndex));
+                    bass.insertPosition(std::move(bassPos));
+                }
+
+                ++noteIndex;
+            }
+        }
+
+        system.insertStaff(std::move(staff));
+    }
+
+    if (systemIndex % 10 == 0)
+    {
+        TempoMarker marker(0);
+        marker.setBeatsPerMinute(80 + (systemIndex / 10) % 80);
+        system.insertTempoMarker(marker);
+    }
+
+    // Rotate the players between the staves every few systems.
+    if (systemIndex % 5 == 0)
+    {
+        PlayerChange change(0);
+        for (int i = 0; i < options.myStaffCount; ++i)
+        {
+            const int player = (i + systemIndex / 5) % options.myStaffCount;
+            change.insertActivePlayer(i, ActivePlayer(player, 0));
+        }
+        system.insertPlayerChange(change);
+    }
+
+    // Musical directions that don't change the playback order.
+    if (systemIndex % 16 == 8)
+    {
+        Direction direction(0);
+        direction.insertSymbol(DirectionSymbol(
+            (systemIndex / 16) % 2 ? DirectionSymbol::Coda
+                                   : DirectionSymbol::Segno));
+        system.insertDirection(direction);
+    }
+
+    return system;
+}
+}
+
+namespace ScoreGenerator
+{
+Options::Options()
+    : mySystemCount(10), myStaffCount(2), myBarsPerSystem(4), mySeed(1)
+{
+}
+
+void generate(Score &score, const Options &options)
+{
+    std::minstd_rand random(options.mySeed);
+
+    for (int i = 0; i < options.myStaffCount; ++i)
+    {
+        Player player;
+        player.setDescription("Player " + std::to_string(i + 1));
+        score.insertPlayer(player);
+    }
+
+    Instrument instrument;
+    score.insertInstrument(instrument);
+
+    for (int i = 0; i < options.mySystemCount; ++i)
+        score.insertSystem(createSystem(random, i, options));
+
+    ScoreUtils::addStandardFilters(score);
+}
+}
@@ -0,0 +1,42 @@
+/*
+  * Copyright (C) 2016 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef TESTUTIL_SCOREGENERATOR_H
+#define TESTUTIL_SCOREGENERATOR_H
+
+class Score;
+
+/// Builds large synthetic scores for scaling tests and benchmarks.
+namespace ScoreGenerator
+{
+struct Options
+{
+    Options();
+
+    int mySystemCount;
+    int myStaffCount;
+    int myBarsPerSystem;
+    /// The same seed always produces the same score.
+    unsigned int mySeed;
+};
+
+/// Fills an empty score with systems of dense notes in both voices, along
+/// with bends, repeats, tempo markers, player changes and directions.
+void generate(Score &score, const Options &options);
+}
+
+#endif
@@ -140,3 +140,35 @@ TEST_CASE("Util/SettingsTree/Remove")
     settings.remove(theKey);
     REQUIRE(settings.get(theKey, -1) == -1);
 }
+
+TEST_CASE("Util/SettingsTree/Setting")
+{
+    const Setting<int> intSetting("test/int_setting", 5);
+    const Setting<std::vector<int>> listSetting("test/list_setting", {});
+    const Setting<int> duplicateSetting("test/int_setting", 0);
+    REQUIRE(duplicateSetting.mySlot == intSetting.mySlot);
+
+    SettingsTree settings;
+    REQUIRE(settings.get(intSetting) == 5);
+    REQUIRE(settings.get(listSetting).empty());
+
+    settings.set(intSetting, 1);
+    settings.set(listSetting, std::vector<int>({ 1, 2 }));
+    REQUIRE(settings.get(intSetting) == 1);
+    REQUIRE(settings.get(listSetting) == std::vector<int>({ 1, 2 }));
+    REQUIRE(settings.get<int>(intSetting.myKey) == 1);
+
+    // Replacing a parent node also updates the setting.
+    settings.set("test", 3);
+    REQUIRE(settings.get(intSetting) == 5);
+
+    settings.set(intSetting, 2);
+    settings.remove("test/int_setting");
+    REQUIRE(settings.get(intSetting) == 5);
+
+    // Settings that are registered after the tree was created still work.
+    const Setting<bool> newSetting("test/new_setting", true);
+    REQUIRE(settings.get(newSetting) == true);
+    settings.set(newSetting, false);
+    REQUIRE(settings.get(newSetting) == false);
+}
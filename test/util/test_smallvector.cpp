@@ -0,0 +1,104 @@
+/*
+  * Copyright (C) 2016 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch.hpp>
+
+#include <algorithm>
+#include <string>
+#include <type_traits>
+#include <util/smallvector.h>
+
+TEST_CASE("Util/SmallVector/Inline", "")
+{
+    SmallVector<std::string, 2> vec;
+    REQUIRE(vec.empty());
+    REQUIRE(vec.isInline());
+
+    vec.push_back("a");
+    vec.push_back("b");
+    REQUIRE(vec.size() == 2);
+    REQUIRE(vec.isInline());
+
+    vec.push_back("c");
+    REQUIRE(vec.size() == 3);
+    REQUIRE(!vec.isInline());
+    REQUIRE(vec[0] == "a");
+    REQUIRE(vec[1] == "b");
+    REQUIRE(vec.back() == "c");
+}
+
+TEST_CASE("Util/SmallVector/Erase", "")
+{
+    SmallVector<std::string, 2> vec;
+    vec.push_back("a");
+    vec.push_back("b");
+    vec.push_back("c");
+
+    vec.erase(std::remove(vec.begin(), vec.end(), "b"), vec.end());
+    REQUIRE(vec.size() == 2);
+    REQUIRE(vec[0] == "a");
+    REQUIRE(vec[1] == "c");
+
+    vec.erase(vec.begin());
+    REQUIRE(vec.size() == 1);
+    REQUIRE(vec.front() == "c");
+
+    vec.clear();
+    REQUIRE(vec.empty());
+}
+
+TEST_CASE("Util/SmallVector/CopyAndMove", "")
+{
+    SmallVector<std::string, 2> small;
+    small.push_back("a");
+
+    SmallVector<std::string, 2> large;
+    for (int i = 0; i < 5; ++i)
+        large.push_back(std::to_string(i));
+
+    SmallVector<std::string, 2> copy(large);
+    REQUIRE(copy == large);
+    copy = small;
+    REQUIRE(copy == small);
+    REQUIRE(copy != large);
+
+    SmallVector<std::string, 2> moved(std::move(large));
+    REQUIRE(moved.size() == 5);
+    REQUIRE(moved[4] == "4");
+    REQUIRE(large.empty());
+
+    moved = std::move(small);
+    REQUIRE(moved.size() == 1);
+    REQUIRE(moved[0] == "a");
+
+    // Moves must not throw, so that std::vector can move elements that contain
+    // a SmallVector when it reallocates.
+    typedef SmallVector<std::string, 2> StringVector;
+    REQUIRE(std::is_nothrow_move_constructible<StringVector>::value);
+    REQUIRE(std::is_nothrow_move_assignable<StringVector>::value);
+}
+
+TEST_CASE("Util/SmallVector/Resize", "")
+{
+    SmallVector<int, 2> vec;
+    vec.resize(4);
+    REQUIRE(vec.size() == 4);
+    REQUIRE(vec[3] == 0);
+
+    vec.resize(1);
+    REQUIRE(vec.size() == 1);
+}
@@ -0,0 +1,49 @@
+/*
+  * Copyright (C) 2016 Cameron White
+  *
+  * This program is free software: you can redistribute it and/or modify
+  * it under the terms of the GNU General Public License as published by
+  * the Free Software Foundation, either version 3 of the License, or
+  * (at your option) any later version.
+  *
+  * This program is distributed in the hope that it will be useful,
+  * but WITHOUT ANY WARRANTY; without even the implied warranty of
+  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  * GNU General Public License for more details.
+  *
+  * You should have received a copy of the GNU General Public License
+  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch.hpp>
+
+#include <sstream>
+#include <util/tracing.h>
+
+TEST_CASE("Util/Tracing", "")
+{
+    using namespace Util::Tracing;
+
+    disable();
+    {
+        Span span("test", "Disabled");
+    }
+
+    enable();
+    {
+        Span span("test", "Enabled");
+        recordCounter("Counter", 42);
+    }
+    disable();
+
+    std::ostringstream output;
+    save(output);
+    const std::string trace = output.str();
+
+    REQUIRE(trace.find("\"traceEvents\"") != std::string::npos);
+    REQUIRE(trace.find("Disabled") == std::string::npos);
+    REQUIRE(trace.find("\"name\":\"Enabled\"") != std::string::npos);
+    REQUIRE(trace.find("\"ph\":\"X\"") != std::string::npos);
+    REQUIRE(trace.find("\"name\":\"Counter\"") != std::string::npos);
+    REQUIRE(trace.find("\"value\":42") != std::string::npos);
+}